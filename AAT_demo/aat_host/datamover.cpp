@@ -0,0 +1,127 @@
+#include "datamover.hpp"
+
+DataMoverClient::DataMoverClient(xrt::device &device, const xrt::uuid &uuid, const std::string &name)
+    : mKernel(device, uuid, name, xrt::kernel::cu_access_mode::exclusive),
+      mTxRing(device, DM_TX_ENTRY_BYTES * DM_RING_LEN, mKernel.group_id(2)),
+      mRxRing(device, DM_RX_ENTRY_BYTES * DM_RING_LEN, mKernel.group_id(3)),
+      mWriteBack(device, DM_WRITE_BACK_BYTES, mKernel.group_id(4)),
+      mUseWriteBack(false),
+      mTxHead(0), mTxReady(0), mTxOverrun(0),
+      mRxTail(0), mRxPublished(0), mRxHead(0)
+{
+    mTxMapped = mTxRing.map<uint8_t*>();
+    mRxMapped = mRxRing.map<uint8_t*>();
+    mWriteBackMapped = mWriteBack.map<uint32_t*>();
+}
+
+void DataMoverClient::start(uint32_t control,
+                            uint32_t rxThrottleRate,
+                            uint32_t writeBackCount,
+                            uint32_t writeBackCycles)
+{
+    // kernel indexes persist across host runs, pick up where they are
+    mTxHead = mKernel.read_register(DM_REG_INDEX_TX_TAIL);
+    mTxReady = mTxHead;
+    mRxHead = mKernel.read_register(DM_REG_INDEX_RX_HEAD);
+    mRxTail = mRxHead;
+    mRxPublished = mRxHead;
+
+    // seed the descriptor so a stale tail is never read before the first write
+    memset(mWriteBackMapped, 0, DM_WRITE_BACK_BYTES);
+    mWriteBackMapped[0] = mTxHead;
+    mWriteBack.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+    mUseWriteBack = (writeBackCount != 0) || (writeBackCycles != 0);
+
+    writeAddress(DM_REG_RING_TX, mTxRing.address());
+    writeAddress(DM_REG_RING_RX, mRxRing.address());
+    writeAddress(DM_REG_WRITE_BACK, mWriteBack.address());
+    mKernel.write_register(DM_REG_INDEX_TX_HEAD, mTxHead);
+    mKernel.write_register(DM_REG_INDEX_RX_TAIL, mRxTail);
+    mKernel.write_register(DM_REG_RX_THROTTLE_RATE, rxThrottleRate);
+    mKernel.write_register(DM_REG_WRITE_BACK_COUNT, writeBackCount);
+    mKernel.write_register(DM_REG_WRITE_BACK_CYCLES, writeBackCycles);
+    mKernel.write_register(DM_REG_CONTROL, control);
+    mKernel.write_register(DM_REG_AP_CTRL, 0x81);	// [7] auto_restart; [0] ap_start
+}
+
+uint32_t DataMoverClient::poll()
+{
+    uint32_t tail;
+
+    if (mUseWriteBack)
+    {
+        mWriteBack.sync(XCL_BO_SYNC_BO_FROM_DEVICE);
+        tail = mWriteBackMapped[0];
+    }
+    else
+    {
+        tail = mKernel.read_register(DM_REG_INDEX_TX_TAIL);
+    }
+
+    // with drop oldest the kernel may lap the ring, anything more than a ring
+    // length behind the tail has been overwritten
+    if ((uint32_t)(tail - mTxHead) > DM_RING_LEN)
+    {
+        mTxOverrun += (uint32_t)(tail - mTxHead) - DM_RING_LEN;
+        mTxHead = tail - DM_RING_LEN;
+        mTxReady = mTxHead;
+    }
+
+    if (tail != mTxReady)
+    {
+        syncRange(mTxRing, XCL_BO_SYNC_BO_FROM_DEVICE, mTxReady, tail, DM_TX_ENTRY_BYTES);
+        mTxReady = tail;
+    }
+
+    return mTxReady - mTxHead;
+}
+
+bool DataMoverClient::push(const dataMoverOperation_t &operation)
+{
+    // only go back to the kernel for its head once the cached one reads full
+    if ((uint32_t)(mRxTail - mRxHead) >= DM_RING_LEN)
+    {
+        mRxHead = mKernel.read_register(DM_REG_INDEX_RX_HEAD);
+        if ((uint32_t)(mRxTail - mRxHead) >= DM_RING_LEN) return false;
+    }
+
+    uint8_t *entry = mRxMapped + (slot(mRxTail) * DM_RX_ENTRY_BYTES);
+    memset(entry, 0, DM_RX_ENTRY_BYTES);
+    entry[0] = operation.direction;
+    memcpy(entry + 1, &operation.price, sizeof(uint32_t));
+    memcpy(entry + 5, &operation.quantity, sizeof(uint32_t));
+    memcpy(entry + 9, &operation.orderId, sizeof(uint32_t));
+    entry[13] = operation.symbolIndex;
+    entry[14] = operation.opCode;
+    memcpy(entry + 15, &operation.timestamp, sizeof(uint64_t));
+    memcpy(entry + 23, &operation.origOrderId, sizeof(uint32_t));
+    ++mRxTail;
+
+    return true;
+}
+
+void DataMoverClient::flush()
+{
+    if (mRxTail == mRxPublished) return;
+
+    syncRange(mRxRing, XCL_BO_SYNC_BO_TO_DEVICE, mRxPublished, mRxTail, DM_RX_ENTRY_BYTES);
+    mKernel.write_register(DM_REG_INDEX_RX_TAIL, mRxTail);
+    mRxPublished = mRxTail;
+}
+
+void DataMoverClient::syncRange(xrt::bo &bo, xclBOSyncDirection dir, uint32_t begin, uint32_t end, size_t entryBytes)
+{
+    // one sync per contiguous span, two where the range wraps the ring
+    uint32_t count = end - begin;
+    uint32_t first = slot(begin);
+    uint32_t span = (count < (DM_RING_LEN - first)) ? count : (DM_RING_LEN - first);
+
+    bo.sync(dir, span * entryBytes, first * entryBytes);
+    if (span < count) bo.sync(dir, (count - span) * entryBytes, 0);
+}
+
+void DataMoverClient::writeAddress(uint32_t offset, uint64_t address)
+{
+    mKernel.write_register(offset, address & 0xffffffff);
+    mKernel.write_register(offset + 4, address >> 32);
+}
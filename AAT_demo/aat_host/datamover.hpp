@@ -0,0 +1,175 @@
+#ifndef DATAMOVER_H
+#define DATAMOVER_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+// XRT includes
+#include "experimental/xrt_bo.h"
+#include "experimental/xrt_device.h"
+#include "experimental/xrt_kernel.h"
+
+// ring geometry, must match OB_DM_RING_INDEX_BITS the kernel was built with
+#ifndef DM_RING_INDEX_BITS
+#define DM_RING_INDEX_BITS   (16)
+#endif
+#define DM_RING_LEN          (1<<DM_RING_INDEX_BITS)
+#define DM_TX_ENTRY_BYTES    (128)	// orderBookResponsePack_t, 1024b
+#define DM_RX_ENTRY_BYTES    (32)	// orderEntryOperationPack_t, 216b in a 256b slot
+#define DM_WRITE_BACK_BYTES  (64)
+
+// orderBookDataMoverTop control, matches OB_DM_* in orderbook.hpp
+#define DM_DROP_OLDEST       (1<<3)
+#define DM_RTT_RESET         (1<<2)
+#define DM_RTT_ENABLE        (1<<1)
+#define DM_HALT              (1<<0)
+
+// orderBookDataMoverTop register map
+#define DM_REG_AP_CTRL           (0x000)
+#define DM_REG_CONTROL           (0x010)
+#define DM_REG_INDEX_TX_HEAD     (0x018)
+#define DM_REG_INDEX_RX_TAIL     (0x020)
+#define DM_REG_RX_THROTTLE_RATE  (0x028)
+#define DM_REG_WRITE_BACK_COUNT  (0x030)
+#define DM_REG_WRITE_BACK_CYCLES (0x038)
+#define DM_REG_INDEX_TX_TAIL     (0x060)
+#define DM_REG_TX_RESPONSE       (0x070)
+#define DM_REG_INDEX_RX_HEAD     (0x080)
+#define DM_REG_RX_OPERATION      (0x090)
+#define DM_REG_TX_OVERFLOW       (0x120)
+#define DM_REG_RX_OVERFLOW       (0x130)
+#define DM_REG_TX_WRITE_BACK     (0x140)
+#define DM_REG_RING_TX           (0x150)
+#define DM_REG_RING_RX           (0x15c)
+#define DM_REG_WRITE_BACK        (0x168)
+
+// read only view of a book response in place in the synced Tx ring, fields
+// follow mmInterface::orderBookResponsePack, levels index 0 at top of book
+class BookResponseView
+{
+public:
+
+    explicit BookResponseView(const uint8_t *entry) : mEntry(entry) {}
+
+    // 56b book timestamp, or the kernel cycle count when RTT is enabled
+    uint64_t timestamp() const {return read64(121, 7);}
+
+    uint8_t symbolIndex() const {return mEntry[120];}
+
+    uint32_t bidCount(int level) const {return read32(100 + 4*level);}
+    uint32_t bidPrice(int level) const {return read32(80 + 4*level);}
+    uint32_t bidQuantity(int level) const {return read32(60 + 4*level);}
+    uint32_t askCount(int level) const {return read32(40 + 4*level);}
+    uint32_t askPrice(int level) const {return read32(20 + 4*level);}
+    uint32_t askQuantity(int level) const {return read32(4*level);}
+
+    const uint8_t* data() const {return mEntry;}
+
+private:
+
+    const uint8_t *mEntry;
+
+    uint32_t read32(int offset) const
+    {
+        uint32_t value;
+        memcpy(&value, mEntry + offset, sizeof(value));
+        return value;
+    }
+
+    uint64_t read64(int offset, int bytes) const
+    {
+        uint64_t value = 0;
+        memcpy(&value, mEntry + offset, bytes);
+        return value;
+    }
+};
+
+// order entry operation as packed by mmInterface::orderEntryOperationPack
+typedef struct dataMoverOperation_t
+{
+    uint64_t timestamp;
+    uint8_t  opCode;
+    uint8_t  symbolIndex;
+    uint32_t orderId;
+    uint32_t quantity;
+    uint32_t price;
+    uint8_t  direction;
+    uint32_t origOrderId;
+} dataMoverOperation_t;
+
+/**
+ * Host client for orderBookDataMoverTop, maps the HBM rings and the tail write
+ * back descriptor and drives the kernel indexes. Each ring is single producer
+ * single consumer with the kernel on the other side, so the Tx consumer and Rx
+ * producer calls need no locks provided each is driven from one host thread.
+ */
+class DataMoverClient
+{
+public:
+
+    DataMoverClient(xrt::device &device, const xrt::uuid &uuid, const std::string &name);
+
+    // program ring addresses and batching, resume at the kernel indexes and
+    // start the kernel with auto_restart, a zero writeBackCount and
+    // writeBackCycles falls back to polling indexTxTail over AXI-Lite
+    void start(uint32_t control,
+               uint32_t rxThrottleRate,
+               uint32_t writeBackCount,
+               uint32_t writeBackCycles);
+
+    // refresh the Tx tail and sync any new responses, returns responses ready
+    uint32_t poll();
+
+    // hand up to max ready responses to handler in place then release their
+    // slots to the kernel, returns the number consumed
+    template <typename F>
+    uint32_t consume(F handler, uint32_t max=DM_RING_LEN)
+    {
+        uint32_t count = 0;
+        while ((mTxHead != mTxReady) && (count < max))
+        {
+            handler(BookResponseView(mTxMapped + (slot(mTxHead) * DM_TX_ENTRY_BYTES)));
+            ++mTxHead;
+            ++count;
+        }
+        if (count > 0) mKernel.write_register(DM_REG_INDEX_TX_HEAD, mTxHead);
+        return count;
+    }
+
+    // stage an operation in the Rx ring, false while the ring is full
+    bool push(const dataMoverOperation_t &operation);
+
+    // sync staged operations and publish them to the kernel
+    void flush();
+
+    uint64_t txOverrun() const {return mTxOverrun;}
+
+    uint32_t readRegister(uint32_t offset) {return mKernel.read_register(offset);}
+
+private:
+
+    xrt::kernel mKernel;
+    xrt::bo mTxRing;
+    xrt::bo mRxRing;
+    xrt::bo mWriteBack;
+    uint8_t *mTxMapped;
+    uint8_t *mRxMapped;
+    uint32_t *mWriteBackMapped;
+    bool mUseWriteBack;
+
+    uint32_t mTxHead;       // next response to hand out
+    uint32_t mTxReady;      // responses synced up to here
+    uint64_t mTxOverrun;    // responses lost to drop oldest
+    uint32_t mRxTail;       // next free operation slot
+    uint32_t mRxPublished;  // operations published to the kernel
+    uint32_t mRxHead;       // kernel head as last read
+
+    static uint32_t slot(uint32_t index) {return index & (DM_RING_LEN-1);}
+
+    void syncRange(xrt::bo &bo, xclBOSyncDirection dir, uint32_t begin, uint32_t end, size_t entryBytes);
+
+    void writeAddress(uint32_t offset, uint64_t address);
+};
+
+#endif
@@ -1,6 +1,10 @@
 #include "cmdlineparser.h"
 #include <iostream>
 #include <cstring>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <algorithm>
 
 // XRT includes
 #include "experimental/xrt_bo.h"
@@ -10,9 +14,36 @@
 
 #include "ap_int.h"
 
+#include "pcap.hpp"
+#include "datamover.hpp"
+
 #define NUM_PACKET           (54)
 #define NUM_FRAME_PER_PACKET (13)
+#define NUM_INPUT_BUFFER     (2)
+#define MAX_BATCH_WORDS      (1<<16)	// 512KB per input buffer
+#define MEM_WORDS_PER_BEAT   (8)
+#define PACE_WINDOW_NS       (100000)	// paced batches span at most 100us of capture time
+#define OUTPUT_IDLE_MS       (50)	// egress collection ends once the ring is idle this long
+#define MW_RING_LEN          (65536)	// 512b slots, matches memWrite
+#define MW_WORDS_PER_SLOT    (8)
+#define MW_REG_AP_CTRL       (0x000)
+#define MW_REG_CONTROL       (0x010)
+#define MW_REG_INDEX_HEAD    (0x018)
+#define MW_REG_INDEX_TAIL    (0x060)
+#define MW_REG_TX_MESSAGE    (0x070)
+#define MW_REG_TX_FRAME      (0x080)
+#define MW_REG_RING_STALL    (0x090)
+#define MW_REG_RING          (0x0d0)
+#define DM_WRITE_BACK_COUNT  (64)	// book responses per tail write back
+#define DM_WRITE_BACK_CYCLES (3000)	// or 10us after the first response not yet reported
 #define NUM_SYMBOL    10
+#define PE_NUM_SYMBOL        (256)	// kernel NUM_SYMBOL, rows per parameter bank
+#define PE_REG_PARAM_COMMIT  (0x050)	// [0] parameter bank selected by the kernel
+#define PE_REG_PARAM_BANK    (0x170)	// [0] parameter bank in use
+#define PE_REG_STRATEGIES    (0x2000)	// regStrategies[bank][symbol], 4 words per entry
+#define PE_REG_LEGS          (0x4000)	// regLegs[bank][symbol], 4 words per entry
+#define PE_REG_ENTRY_BYTES   (16)
+#define PE_COMMIT_POLL       (1000)
 
 ap_uint<64> byteReverse(ap_uint<64> inputData){
     ap_uint<64> reversed = (inputData.range(7,0),
@@ -27,6 +58,21 @@ ap_uint<64> byteReverse(ap_uint<64> inputData){
     return reversed;
 }
 
+// words a packet occupies in a memRead batch, length header plus payload
+size_t packetWords(const pcapPacket_t &packet){
+    return 1 + ((packet.length + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+}
+
+// [15:0] payload length in bytes, then the payload with the first byte in
+// [7:0] of the first word and the final word zero padded
+size_t packPacket(uint64_t *dest, const pcapPacket_t &packet){
+    size_t words = packetWords(packet);
+    dest[0] = packet.length;
+    dest[words - 1] = 0;
+    memcpy(&dest[1], packet.data, packet.length);
+    return words;
+}
+
 typedef struct orderEntryOperation_t{
     ap_uint<64> timestamp;
     ap_uint<8>  opCode;
@@ -35,6 +81,7 @@ typedef struct orderEntryOperation_t{
     ap_uint<32> quantity;
     ap_uint<32> price;
     ap_uint<8>  direction;
+    ap_uint<32> origOrderId;
 } orderEntryOperation_t;
 
 
@@ -46,11 +93,21 @@ int main(int argc, char** argv) {
     //**************//"<Full Arg>",  "<Short Arg>", "<Description>", "<Default>"
     parser.addSwitch("--xclbin_file", "-x", "input binary file string", "");
     parser.addSwitch("--device_id", "-d", "device index", "0");
+    parser.addSwitch("--pcap_file", "-p", "pcap capture to replay, compiled in golden packets if empty", "");
+    parser.addSwitch("--udp_port", "-u", "UDP destination port filter for the capture, 0 for any", "0");
+    parser.addSwitch("--pace", "-r", "replay speed relative to capture time, 0 for as fast as possible", "0");
+    parser.addSwitch("--batch_size", "-b", "maximum packets per memRead launch", "1024");
+    parser.addSwitch("--data_mover", "-m", "forward book responses to host through orderBookDataMoverTop", "", true);
     parser.parse(argc, argv);
 
     // Read settings
     std::string binaryFile = parser.value("xclbin_file");
     int device_index = stoi(parser.value("device_id"));
+    std::string pcapFile = parser.value("pcap_file");
+    uint16_t udpPort = stoi(parser.value("udp_port"));
+    double pace = stod(parser.value("pace"));
+    size_t batchPackets = std::max(1, stoi(parser.value("batch_size")));
+    bool dataMover = (parser.value("data_mover") == "true");
 
     if (argc < 3) {
         parser.printHelp();
@@ -65,7 +122,8 @@ int main(int argc, char** argv) {
 	// set kernel & ip
 	// If the kernel HLS INTERFACE is "ap_ctrl_none", the kernel must use xrt::ip
 	auto mem_read = xrt::kernel(device, uuid, "memRead");
-    auto mem_write = xrt::kernel(device, uuid, "memWrite");
+	// memWrite runs continuously with auto_restart, registers need exclusive access
+    auto mem_write = xrt::kernel(device, uuid, "memWrite", xrt::kernel::cu_access_mode::exclusive);
 	auto ip_m = xrt::kernel(device, uuid, "ip_m");
 	auto ip_s = xrt::kernel(device, uuid, "ip_s");
 	auto feedHandlerTop = xrt::ip(device, uuid, "feedHandlerTop");
@@ -73,13 +131,15 @@ int main(int argc, char** argv) {
 	auto pricingEngineTop = xrt::ip(device, uuid, "pricingEngineTop");
 	auto orderEntryTcpTop = xrt::ip(device, uuid, "orderEntryTcpTop");
 	
-    size_t input_size = NUM_FRAME_PER_PACKET, output_size = 32;
-	
 	/*** order Entry Tcp Networking Setting ***/
 	orderEntryTcpTop.write_register(0x018, 0xdeadbeef); // regControl configuration
 	orderEntryTcpTop.write_register(0x020, 0x00000000);	// regControl configuration
 	orderEntryTcpTop.write_register(0x028, 0x640aa8c0);	// Destination address for egress IP sends, 192.168.10.100
 	orderEntryTcpTop.write_register(0x030, 0x17);		// Destination port for egress IP sends, telnet (port 23)
+	orderEntryTcpTop.write_register(0x038, 0x00000000);	// [0] Session protocol select, 0=FIX ASCII 1=binary
+	orderEntryTcpTop.write_register(0x040, 0x20211201);	// FIX SendingTime date, BCD YYYYMMDD
+	orderEntryTcpTop.write_register(0x048, 0x00093000);	// [23:0] FIX SendingTime time of day, BCD HHMMSS
+	orderEntryTcpTop.write_register(0x048, 0x80093000);	// [31] Load time of day on rising edge
 	orderEntryTcpTop.write_register(0x010, ((1<<4) | (1<<3)));// [4] Enable partial checksum calculation and forwarding; [3] Initiate egress TCP connection request
 
 	// ip_s config
@@ -134,9 +194,11 @@ int main(int argc, char** argv) {
 	// set Feed Handler symbols
 	ap_uint<32> symbols[NUM_SYMBOL] = {0x11111111, 0x22222222, 0x33333333, 0x44444444, 0x55555555, 0x66666666, 0x77777777, 0x88888888, 0x99999999, 0x12345678};
 	for (size_t i = 0; i < NUM_SYMBOL; i++) feedHandlerTop.write_register(0x0b8 + sizeof(ap_uint<32>)*i, symbols[i]);	// write to Feed Handler register
+	//[31:0] Kernel cycles between clock ticks to the pricing engine, 0 disables
+	feedHandlerTop.write_register(0x020, 0x0004e200);	// 1ms at 320MHz, matches OE_CLOCK_CYCLES_PER_MS
 
 	// Order Book regControl configuration
-	orderBookTop.write_register(0x010, 0x00000000);
+	orderBookTop.write_register(0x010, (dataMover ? (1<<3) : 0x00000000));	// [3] Forward responses to the data mover
 	orderBookTop.write_register(0x018, 0xdeadbeef);
 	orderBookTop.write_register(0x020, 0x00000000);
 
@@ -146,42 +208,234 @@ int main(int argc, char** argv) {
 	pricingEngineTop.write_register(0x020, 0x00000000);
 	//[31] Enable global strategy override for allsymbols; [7:0] Global strategy select for all symbols
 	pricingEngineTop.write_register(0x028, 0x80000001);	
+	//[31:0] Number of top of book updates cached per symbol before it may trade
+	pricingEngineTop.write_register(0x038, 0x00000001);
+
+	// strategy parameters are double buffered, program the bank the kernel is
+	// not reading, select it with one paramCommit write and wait for paramBank
+	// to follow before the previous bank may be written again
+	uint32_t paramBank = (pricingEngineTop.read_register(PE_REG_PARAM_BANK) & 0x1) ^ 0x1;
+	for (size_t i = 0; i < NUM_SYMBOL; i++) {
+		uint32_t strategy = PE_REG_STRATEGIES + ((paramBank * PE_NUM_SYMBOL) + i) * PE_REG_ENTRY_BYTES;
+		uint32_t legs = PE_REG_LEGS + ((paramBank * PE_NUM_SYMBOL) + i) * PE_REG_ENTRY_BYTES;
+		pricingEngineTop.write_register(strategy + 0x0, 0x00000001);	// select, PEG
+		pricingEngineTop.write_register(strategy + 0x4, 0x00000000);	// enable, no thresholds
+		pricingEngineTop.write_register(strategy + 0x8, 0x00000000);	// totalBid
+		pricingEngineTop.write_register(strategy + 0xc, 0x00000000);	// totalAsk
+		pricingEngineTop.write_register(legs + 0x0, 0x00000000);	// legs
+		pricingEngineTop.write_register(legs + 0x4, 0x00000000);	// weights, spread unused
+		pricingEngineTop.write_register(legs + 0x8, 0x00000000);	// threshold
+		pricingEngineTop.write_register(legs + 0xc, 0x00000000);	// quantity
+	}
+	pricingEngineTop.write_register(PE_REG_PARAM_COMMIT, paramBank);
+	size_t commitPoll = 0;
+	while (((pricingEngineTop.read_register(PE_REG_PARAM_BANK) & 0x1) != paramBank) && (++commitPoll < PE_COMMIT_POLL)) {
+		std::this_thread::sleep_for(std::chrono::microseconds(10));
+	}
+	if (commitPoll >= PE_COMMIT_POLL) {
+		std::cout << "Pricing engine parameter commit to bank " << paramBank << " not acknowledged" << std::endl;
+		return EXIT_FAILURE;
+	}
 
-	//input data map
-    auto buffer_input = xrt::bo(device, sizeof(ap_uint<64>) * input_size, mem_read.group_id(0));
-	auto buffer_input_mapped = buffer_input.map<ap_uint<64>*>();
-	//output data map
-    auto buffer_output = xrt::bo(device, sizeof(ap_uint<64>) * output_size, mem_write.group_id(0));
-	auto buffer_output_mapped = buffer_output.map<ap_uint<64>*>();	
+	// packet source, a capture file when given, otherwise the golden packets
+	PcapReader pcap;
+	std::vector<uint8_t> goldenPayload(NUM_PACKET * NUM_FRAME_PER_PACKET * sizeof(uint64_t));
+	size_t goldenIndex = 0;
+	if (!pcapFile.empty()) {
+		if (!pcap.open(pcapFile, udpPort)) return EXIT_FAILURE;
+		std::cout << "Replay " << pcapFile << " (" << pcap.size() << " bytes)" << std::endl;
+	}
+	else {
+		// golden words hold the payload bytes most significant first
+		for (size_t n = 0; n < NUM_PACKET; n++){
+			for (size_t i = 0; i < NUM_FRAME_PER_PACKET; i++){
+				uint64_t word = byteReverse(inputWords[n][i]).to_uint64();
+				memcpy(&goldenPayload[((n * NUM_FRAME_PER_PACKET) + i) * sizeof(uint64_t)], &word, sizeof(uint64_t));
+			}
+		}
+	}
+	auto nextPacket = [&](pcapPacket_t &packet) -> bool {
+		if (!pcapFile.empty()) return pcap.next(packet);
+		if (goldenIndex >= NUM_PACKET) return false;
+		packet.timestamp = 0;
+		packet.length = NUM_FRAME_PER_PACKET * sizeof(uint64_t);
+		packet.data = &goldenPayload[goldenIndex * packet.length];
+		++goldenIndex;
+		return true;
+	};
+
+	//input data map, batches are double buffered so the host fills one
+	//buffer while memRead streams the other, runs queue on the CU back to back
+	std::vector<xrt::bo> buffer_input;
+	std::vector<uint64_t*> buffer_input_mapped;
+	std::vector<xrt::run> read_run;
+	for (size_t b = 0; b < NUM_INPUT_BUFFER; b++){
+		buffer_input.push_back(xrt::bo(device, sizeof(ap_uint<64>) * MAX_BATCH_WORDS, mem_read.group_id(0)));
+		buffer_input_mapped.push_back(buffer_input[b].map<uint64_t*>());
+		read_run.push_back(xrt::run(mem_read));
+		read_run[b].set_arg(0, buffer_input[b]);
+	}
+	//output ring map, each order is a header slot followed by its payload
+    auto buffer_ring = xrt::bo(device, sizeof(ap_uint<512>) * MW_RING_LEN, mem_write.group_id(2));
+	auto buffer_ring_mapped = buffer_ring.map<uint64_t*>();
 	
-	//declare kernel run
-	auto write_run = xrt::run(mem_write);
-	auto read_run = xrt::run(mem_read);
-	//set kernel arg
-	write_run.set_arg(0, buffer_output);
-    write_run.set_arg(1, output_size);
-    read_run.set_arg(0, buffer_input);
-    read_run.set_arg(1, input_size);	
- 
-	for (size_t n = 0; n < NUM_PACKET; n++){
-		std::cout << "PACKET #" << std::dec << n << std::endl;
-		// send udp packet
-		for (size_t i = 0; i < input_size; i++) buffer_input_mapped[i] = byteReverse(inputWords[n][i]);
-		buffer_input.sync(XCL_BO_SYNC_BO_TO_DEVICE);
-		read_run.start();
-		read_run.wait();
-		
+	//memWrite indexes persist across runs, resume consuming at its tail
+	uint32_t egressHead = mem_write.read_register(MW_REG_INDEX_TAIL);
+	mem_write.write_register(MW_REG_INDEX_HEAD, egressHead);
+	mem_write.write_register(MW_REG_RING, buffer_ring.address() & 0xffffffff);
+	mem_write.write_register(MW_REG_RING + 4, buffer_ring.address() >> 32);
+	mem_write.write_register(MW_REG_AP_CTRL, 0x81);	// [7] auto_restart; [0] ap_start
+
+	// consume every order published since the last call with one register read
+	// and one sync per contiguous span, the head write returns the slots
+	uint64_t statEgressMessages = 0, statEgressBytes = 0;
+	bool printEgress = pcapFile.empty();
+	auto collectEgress = [&]() -> uint32_t {
+		uint32_t tail = mem_write.read_register(MW_REG_INDEX_TAIL);
+		uint32_t slots = tail - egressHead;
+		uint32_t messages = 0;
+		if (slots == 0) return 0;
 
-		// receive tcp packet
-		write_run.start();
-		write_run.wait();
-		buffer_output.sync(XCL_BO_SYNC_BO_FROM_DEVICE); // Copy Result from Device Global Memory to Host Local Memory
-		for(size_t k=0; k<output_size; k++){
-			std::cout << std::hex <<  buffer_output_mapped[k] << std::endl;
+		uint32_t first = egressHead % MW_RING_LEN;
+		uint32_t span = std::min<uint32_t>(slots, MW_RING_LEN - first);
+		buffer_ring.sync(XCL_BO_SYNC_BO_FROM_DEVICE, span * sizeof(ap_uint<512>), first * sizeof(ap_uint<512>));
+		if (span < slots) buffer_ring.sync(XCL_BO_SYNC_BO_FROM_DEVICE, (slots - span) * sizeof(ap_uint<512>), 0);
+
+		while (egressHead != tail) {
+			const uint64_t *header = &buffer_ring_mapped[(egressHead % MW_RING_LEN) * MW_WORDS_PER_SLOT];
+			uint32_t words = header[1] & 0xffffffff;
+			uint32_t length = (header[0] >> 16) & 0xffff;
+			if (printEgress) {
+				std::cout << std::dec << "ORDER #" << (header[1] >> 32) << " session " << (header[0] & 0xffff)
+						  << " length " << length << std::endl;
+				for (uint32_t k = 0; k < words; k++) {
+					uint32_t slot = (egressHead + 1 + (k / MW_WORDS_PER_SLOT)) % MW_RING_LEN;
+					std::cout << std::hex << buffer_ring_mapped[(slot * MW_WORDS_PER_SLOT) + (k % MW_WORDS_PER_SLOT)] << std::endl;
+				}
+			}
+			egressHead += 1 + ((words + MW_WORDS_PER_SLOT - 1) / MW_WORDS_PER_SLOT);
+			statEgressBytes += length;
+			++statEgressMessages;
+			++messages;
 		}
-		std::cout << std::endl;	
-		
+		mem_write.write_register(MW_REG_INDEX_HEAD, egressHead);
+		return messages;
+	};
+
+	// book responses forwarded to host through the data mover ring
+	DataMoverClient *mover = NULL;
+	uint64_t statBookResponses = 0;
+	auto collectBook = [&]() {
+		if (mover == NULL || mover->poll() == 0) return;
+		statBookResponses += mover->consume([&](const BookResponseView &response) {
+			if (pcapFile.empty()) {
+				std::cout << std::dec << "BOOK_RESPONSE[" << (int)response.symbolIndex() << "]: "
+						  << response.bidQuantity(0) << "@" << response.bidPrice(0) << " || "
+						  << response.askQuantity(0) << "@" << response.askPrice(0) << std::endl;
+			}
+		});
+	};
+	if (dataMover) {
+		mover = new DataMoverClient(device, uuid, "orderBookDataMoverTop");
+		mover->start(0, 0, DM_WRITE_BACK_COUNT, DM_WRITE_BACK_CYCLES);
+	}
+
+	// replay statistics
+	typedef std::chrono::steady_clock replayClock;
+	uint64_t statPackets = 0, statBytes = 0, statBatches = 0;
+	double turnaroundMin = 1e12, turnaroundMax = 0, turnaroundSum = 0;
+	double latenessMax = 0, latenessSum = 0;
+	uint64_t turnaroundCount = 0;
+	std::vector<replayClock::time_point> runStart(NUM_INPUT_BUFFER);
+
+	pcapPacket_t packet;
+	bool pending = nextPacket(packet);
+	uint64_t captureStart = packet.timestamp;
+	replayClock::time_point replayStart = replayClock::now();
+
+	while (pending){
+		size_t b = statBatches % NUM_INPUT_BUFFER;
+		// wait for the run that last streamed this buffer before refilling it
+		if (statBatches >= NUM_INPUT_BUFFER) {
+			read_run[b].wait();
+			double turnaround = std::chrono::duration<double, std::micro>(replayClock::now() - runStart[b]).count();
+			turnaroundMin = std::min(turnaroundMin, turnaround);
+			turnaroundMax = std::max(turnaroundMax, turnaround);
+			turnaroundSum += turnaround;
+			++turnaroundCount;
+		}
+
+		// each packet is a length header word followed by its payload, paced
+		// batches also close on the pacing window
+		size_t packets = 0, words = 0;
+		uint64_t batchTimestamp = packet.timestamp;
+		while (pending && (packets < batchPackets) && ((words + packetWords(packet)) <= MAX_BATCH_WORDS) &&
+			   ((pace == 0) || ((packet.timestamp - batchTimestamp) < PACE_WINDOW_NS))) {
+			words += packPacket(buffer_input_mapped[b] + words, packet);
+			statBytes += packet.length;
+			++packets;
+			pending = nextPacket(packet);
+		}
+		// zero length headers pad the batch to whole 512b beats
+		while (words % MEM_WORDS_PER_BEAT) buffer_input_mapped[b][words++] = 0;
+
+		// real time pacing at batch granularity, scaled by the pace factor
+		if (pace > 0) {
+			replayClock::time_point due = replayStart + std::chrono::nanoseconds((uint64_t)((batchTimestamp - captureStart) / pace));
+			std::this_thread::sleep_until(due);
+			double lateness = std::chrono::duration<double, std::micro>(replayClock::now() - due).count();
+			latenessMax = std::max(latenessMax, lateness);
+			latenessSum += lateness;
+		}
+
+		buffer_input[b].sync(XCL_BO_SYNC_BO_TO_DEVICE, words * sizeof(uint64_t), 0);
+		read_run[b].set_arg(1, words);
+		runStart[b] = replayClock::now();
+		read_run[b].start();
+		statPackets += packets;
+		++statBatches;
+
+		collectEgress();
+		collectBook();
+	}
+	for (size_t b = 0; b < std::min<uint64_t>(statBatches, NUM_INPUT_BUFFER); b++) read_run[b].wait();
+	double elapsed = std::chrono::duration<double>(replayClock::now() - replayStart).count();
+
+	std::cout << std::dec << "Replay" << std::endl;
+	std::cout << "Packets: " << statPackets << ", payload bytes: " << statBytes << ", batches: " << statBatches << std::endl;
+	if (!pcapFile.empty()) std::cout << "Capture records skipped: " << pcap.skipped() << std::endl;
+	if (elapsed > 0) {
+		std::cout << "Elapsed: " << elapsed << " s, " << (statPackets / elapsed / 1e6) << " Mpps, "
+				  << (statBytes * 8 / elapsed / 1e9) << " Gbps" << std::endl;
+	}
+	if (turnaroundCount > 0) {
+		std::cout << "Batch turnaround (start to buffer reuse) us min/avg/max: " << turnaroundMin << "/"
+				  << (turnaroundSum / turnaroundCount) << "/" << turnaroundMax << std::endl;
+	}
+	if (pace > 0 && statBatches > 0) {
+		std::cout << "Pacing lateness us avg/max: " << (latenessSum / statBatches) << "/" << latenessMax << std::endl;
+	}
+
+	// receive tcp packets, until the pipeline has drained
+	replayClock::time_point lastEgress = replayClock::now();
+	while ((replayClock::now() - lastEgress) < std::chrono::milliseconds(OUTPUT_IDLE_MS)) {
+		if (collectEgress() > 0) lastEgress = replayClock::now();
+		else std::this_thread::sleep_for(std::chrono::microseconds(100));
+		collectBook();
+	}
+	if (mover != NULL) {
+		std::cout << std::dec << "Book responses via data mover: " << statBookResponses
+				  << ", overrun: " << mover->txOverrun()
+				  << ", kernel tx: " << mover->readRegister(DM_REG_TX_RESPONSE)
+				  << ", ring full: " << mover->readRegister(DM_REG_TX_OVERFLOW)
+				  << ", write backs: " << mover->readRegister(DM_REG_TX_WRITE_BACK) << std::endl;
+		delete mover;
 	}
+	std::cout << std::dec << "Egress messages: " << statEgressMessages << ", payload bytes: " << statEgressBytes << std::endl;
+	std::cout << "memWrite messages: " << mem_write.read_register(MW_REG_TX_MESSAGE)
+			  << ", frames: " << mem_write.read_register(MW_REG_TX_FRAME)
+			  << ", ring full stalls: " << mem_write.read_register(MW_REG_RING_STALL) << std::endl;
+	std::cout << std::endl;	
 
 	std::cout << std::dec << "orderEntryTcpTop" << std::endl;
 	std::cout << "Number of order entry operations received: " << orderEntryTcpTop.read_register(0x058) << std::endl;
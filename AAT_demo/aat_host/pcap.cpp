@@ -0,0 +1,215 @@
+#include "pcap.hpp"
+
+#include <iostream>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define PCAP_MAGIC_USEC      (0xa1b2c3d4)
+#define PCAP_MAGIC_NSEC      (0xa1b23c4d)
+#define PCAPNG_MAGIC         (0x0a0d0d0a)
+#define PCAP_FILE_HEADER_LEN (24)
+#define PCAP_REC_HEADER_LEN  (16)
+
+#define LINKTYPE_ETHERNET    (1)
+#define LINKTYPE_RAW         (101)
+#define LINKTYPE_LINUX_SLL   (113)
+#define LINKTYPE_IPV4        (228)
+
+#define ETHERTYPE_IPV4       (0x0800)
+#define ETHERTYPE_VLAN       (0x8100)
+#define ETHERTYPE_QINQ       (0x88a8)
+#define IP_PROTOCOL_UDP      (17)
+#define UDP_HEADER_LEN       (8)
+
+static inline uint16_t readBe16(const uint8_t *p)
+{
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+PcapReader::PcapReader()
+    : mData(NULL), mSize(0), mOffset(0), mFd(-1), mSwap(false), mNano(false),
+      mLinkType(0), mPort(0), mSkipped(0)
+{
+}
+
+PcapReader::~PcapReader()
+{
+    close();
+}
+
+bool PcapReader::open(const std::string &path, uint16_t port)
+{
+    struct stat st;
+    uint32_t magic;
+
+    close();
+
+    mFd = ::open(path.c_str(), O_RDONLY);
+    if (mFd < 0 || fstat(mFd, &st) != 0)
+    {
+        std::cout << "ERROR: unable to open capture " << path << std::endl;
+        close();
+        return false;
+    }
+
+    mSize = st.st_size;
+    if (mSize < PCAP_FILE_HEADER_LEN)
+    {
+        std::cout << "ERROR: capture " << path << " is too short" << std::endl;
+        close();
+        return false;
+    }
+
+    void *map = mmap(NULL, mSize, PROT_READ, MAP_PRIVATE, mFd, 0);
+    if (map == MAP_FAILED)
+    {
+        std::cout << "ERROR: unable to map capture " << path << std::endl;
+        mSize = 0;
+        close();
+        return false;
+    }
+    mData = (const uint8_t*)map;
+    madvise(map, mSize, MADV_SEQUENTIAL);
+
+    memcpy(&magic, mData, sizeof(magic));
+    mSwap = false;
+    if (magic == __builtin_bswap32(PCAP_MAGIC_USEC) || magic == __builtin_bswap32(PCAP_MAGIC_NSEC))
+    {
+        mSwap = true;
+        magic = __builtin_bswap32(magic);
+    }
+
+    if (magic == PCAPNG_MAGIC)
+    {
+        std::cout << "ERROR: pcapng is not supported, convert with 'editcap -F pcap'" << std::endl;
+        close();
+        return false;
+    }
+    else if (magic != PCAP_MAGIC_USEC && magic != PCAP_MAGIC_NSEC)
+    {
+        std::cout << "ERROR: " << path << " is not a pcap capture" << std::endl;
+        close();
+        return false;
+    }
+
+    mNano = (magic == PCAP_MAGIC_NSEC);
+    mLinkType = read32(mData + 20) & 0x0fffffff;
+    if (mLinkType != LINKTYPE_ETHERNET && mLinkType != LINKTYPE_RAW &&
+        mLinkType != LINKTYPE_LINUX_SLL && mLinkType != LINKTYPE_IPV4)
+    {
+        std::cout << "ERROR: unsupported link type " << mLinkType << std::endl;
+        close();
+        return false;
+    }
+
+    mPort = port;
+    mOffset = PCAP_FILE_HEADER_LEN;
+    mSkipped = 0;
+    return true;
+}
+
+void PcapReader::close()
+{
+    if (mData != NULL) munmap((void*)mData, mSize);
+    if (mFd >= 0) ::close(mFd);
+    mData = NULL;
+    mSize = 0;
+    mOffset = 0;
+    mFd = -1;
+}
+
+bool PcapReader::next(pcapPacket_t &packet)
+{
+    while ((mOffset + PCAP_REC_HEADER_LEN) <= mSize)
+    {
+        const uint8_t *rec = mData + mOffset;
+        uint64_t seconds = read32(rec);
+        uint64_t fraction = read32(rec + 4);
+        uint32_t captured = read32(rec + 8);
+
+        if ((mOffset + PCAP_REC_HEADER_LEN + captured) > mSize)
+        {
+            // truncated final record, e.g. capture still being written
+            break;
+        }
+        mOffset += PCAP_REC_HEADER_LEN + captured;
+
+        const uint8_t *frame = rec + PCAP_REC_HEADER_LEN;
+        const uint8_t *ip = ipv4(frame, captured);
+        if (ip == NULL)
+        {
+            ++mSkipped;
+            continue;
+        }
+
+        const uint8_t *end = frame + captured;
+        uint32_t ipHeaderLen = (ip[0] & 0x0f) * 4;
+        uint16_t fragment = readBe16(ip + 6);
+        const uint8_t *udp = ip + ipHeaderLen;
+
+        // only unfragmented UDP datagrams carry a complete MDP packet
+        if (((ip[0] >> 4) != 4) || (ip[9] != IP_PROTOCOL_UDP) ||
+            (fragment & 0x3fff) || ((udp + UDP_HEADER_LEN) > end))
+        {
+            ++mSkipped;
+            continue;
+        }
+
+        uint16_t udpLength = readBe16(udp + 4);
+        if ((mPort != 0 && readBe16(udp + 2) != mPort) ||
+            (udpLength <= UDP_HEADER_LEN) || ((udp + udpLength) > end))
+        {
+            ++mSkipped;
+            continue;
+        }
+
+        packet.timestamp = (seconds * 1000000000ULL) + (mNano ? fraction : (fraction * 1000));
+        packet.data = udp + UDP_HEADER_LEN;
+        packet.length = udpLength - UDP_HEADER_LEN;
+        return true;
+    }
+
+    return false;
+}
+
+uint32_t PcapReader::read32(const uint8_t *p) const
+{
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return (mSwap ? __builtin_bswap32(value) : value);
+}
+
+const uint8_t* PcapReader::ipv4(const uint8_t *frame, uint32_t length) const
+{
+    uint32_t offset = 0;
+    uint16_t etherType = ETHERTYPE_IPV4;
+
+    switch (mLinkType)
+    {
+        case LINKTYPE_ETHERNET:
+            offset = 14;
+            if (length < offset) return NULL;
+            etherType = readBe16(frame + 12);
+            while ((etherType == ETHERTYPE_VLAN || etherType == ETHERTYPE_QINQ) && (offset + 4) <= length)
+            {
+                etherType = readBe16(frame + offset + 2);
+                offset += 4;
+            }
+            break;
+        case LINKTYPE_LINUX_SLL:
+            offset = 16;
+            if (length < offset) return NULL;
+            etherType = readBe16(frame + 14);
+            break;
+        default:
+            break;
+    }
+
+    // minimum IPv4 header
+    if (etherType != ETHERTYPE_IPV4 || (offset + 20) > length) return NULL;
+
+    return frame + offset;
+}
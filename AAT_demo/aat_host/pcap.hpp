@@ -0,0 +1,56 @@
+#ifndef PCAP_H
+#define PCAP_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+// UDP payload extracted from a capture, data points into the mapped file so
+// a full trading day can be replayed without copying it through the heap
+typedef struct pcapPacket_t
+{
+    uint64_t       timestamp; // capture time in ns
+    const uint8_t *data;      // UDP payload
+    uint32_t       length;    // UDP payload length in bytes
+} pcapPacket_t;
+
+// Reader for classic libpcap captures (usec or nsec, either byte order) on
+// Ethernet (with VLAN tags), Linux cooked or raw IPv4 links. IPv4 fragments,
+// non UDP traffic and datagrams not matching the port filter are skipped.
+class PcapReader
+{
+public:
+
+    PcapReader();
+    ~PcapReader();
+
+    // map the capture, port 0 accepts any UDP destination port
+    bool open(const std::string &path, uint16_t port);
+
+    void close();
+
+    // next UDP payload in capture order, false at the end of the capture
+    bool next(pcapPacket_t &packet);
+
+    uint64_t skipped() const {return mSkipped;}
+
+    size_t size() const {return mSize;}
+
+private:
+
+    const uint8_t *mData;
+    size_t mSize;
+    size_t mOffset;
+    int mFd;
+    bool mSwap;
+    bool mNano;
+    uint32_t mLinkType;
+    uint16_t mPort;
+    uint64_t mSkipped;
+
+    uint32_t read32(const uint8_t *p) const;
+
+    const uint8_t* ipv4(const uint8_t *frame, uint32_t length) const;
+};
+
+#endif
@@ -0,0 +1,251 @@
+/*
+ * Copyright 2021 Xilinx, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <iostream>
+
+#include "datamover.hpp"
+
+// kernel indexes start just short of the 32b wrap so both the ring slot and
+// the free running index wrap during the test
+#define NUM_TEST_INDEX_START_DM (0xfffffff8)
+#define NUM_TEST_TX_DM          (10)
+
+// kernel side of the Tx ring, write count responses tagged with their index
+// at the tail and advance it, with drop oldest this laps unread entries
+void kernelRespond(uint32_t count)
+{
+    uint8_t *ring = xrt_mock::device(2);
+    uint32_t tail = xrt_mock::state().registers[DM_REG_INDEX_TX_TAIL];
+
+    for (uint32_t i=0; i<count; i++)
+    {
+        memcpy(ring + ((tail & (DM_RING_LEN-1)) * DM_TX_ENTRY_BYTES), &tail, sizeof(tail));
+        ++tail;
+    }
+    xrt_mock::state().registers[DM_REG_INDEX_TX_TAIL] = tail;
+}
+
+// consume everything ready, checking responses arrive in index order
+int consumeCheck(DataMoverClient &client, uint32_t expectedFirst, uint32_t expectedCount)
+{
+    uint32_t expected = expectedFirst;
+    int mismatch = 0;
+
+    uint32_t count = client.consume([&](const BookResponseView &response)
+    {
+        if (expected != response.askQuantity(0))
+        {
+            std::cout << "MISMATCH: response " << response.askQuantity(0) << " expected " << expected << std::endl;
+            ++mismatch;
+        }
+        ++expected;
+    });
+
+    if (expectedCount != count)
+    {
+        std::cout << "MISMATCH: consumed " << count << " expected " << expectedCount << std::endl;
+        ++mismatch;
+    }
+
+    return mismatch;
+}
+
+int main()
+{
+    xrt::device device;
+    xrt::uuid uuid;
+    uint32_t start = NUM_TEST_INDEX_START_DM;
+    uint32_t ready;
+    uint32_t syncHeld;
+    int txMismatch=0;
+    int rxMismatch=0;
+
+    std::cout << "DataMoverClient Test" << std::endl;
+    std::cout << "--------------------" << std::endl;
+
+    // Tx ring polled over AXI-Lite, client resumes at the kernel indexes
+    xrt_mock::reset();
+    xrt_mock::state().registers[DM_REG_INDEX_TX_TAIL] = start;
+    xrt_mock::state().registers[DM_REG_INDEX_RX_HEAD] = start;
+    DataMoverClient client(device, uuid, "orderBookDataMoverTop");
+    client.start(DM_DROP_OLDEST, 0, 0, 0);
+
+    if ((start != xrt_mock::state().registers[DM_REG_INDEX_TX_HEAD]) ||
+        (start != xrt_mock::state().registers[DM_REG_INDEX_RX_TAIL]) ||
+        (DM_DROP_OLDEST != xrt_mock::state().registers[DM_REG_CONTROL]) ||
+        (0x81 != xrt_mock::state().registers[DM_REG_AP_CTRL]))
+    {
+        std::cout << "MISMATCH: start did not resume at kernel indexes" << std::endl;
+        ++txMismatch;
+    }
+
+    // responses across the ring end are synced as two spans
+    kernelRespond(NUM_TEST_TX_DM);
+    syncHeld = xrt_mock::state().syncCount;
+    ready = client.poll();
+    if ((NUM_TEST_TX_DM != ready) || ((syncHeld+2) != xrt_mock::state().syncCount))
+    {
+        std::cout << "MISMATCH: poll ready=" << ready << " syncs=" << (xrt_mock::state().syncCount - syncHeld) << std::endl;
+        ++txMismatch;
+    }
+
+    // partial consume only releases the slots handed out
+    if (4 != client.consume([](const BookResponseView &) {}, 4))
+    {
+        std::cout << "MISMATCH: partial consume" << std::endl;
+        ++txMismatch;
+    }
+    if ((start+4) != xrt_mock::state().registers[DM_REG_INDEX_TX_HEAD])
+    {
+        std::cout << "MISMATCH: head " << xrt_mock::state().registers[DM_REG_INDEX_TX_HEAD] << " after partial consume" << std::endl;
+        ++txMismatch;
+    }
+    txMismatch += consumeCheck(client, start+4, NUM_TEST_TX_DM-4);
+    if ((start+NUM_TEST_TX_DM) != xrt_mock::state().registers[DM_REG_INDEX_TX_HEAD])
+    {
+        std::cout << "MISMATCH: head " << xrt_mock::state().registers[DM_REG_INDEX_TX_HEAD] << " after wrap" << std::endl;
+        ++txMismatch;
+    }
+
+    // no new responses, nothing to sync
+    syncHeld = xrt_mock::state().syncCount;
+    if ((0 != client.poll()) || (syncHeld != xrt_mock::state().syncCount))
+    {
+        std::cout << "MISMATCH: idle poll" << std::endl;
+        ++txMismatch;
+    }
+
+    // kernel laps the ring by 5 under drop oldest, the oldest 5 are counted as
+    // overrun and the newest ring length are handed out
+    kernelRespond(DM_RING_LEN+5);
+    ready = client.poll();
+    if ((DM_RING_LEN != ready) || (5 != client.txOverrun()))
+    {
+        std::cout << "MISMATCH: overrun ready=" << ready << " txOverrun=" << client.txOverrun() << std::endl;
+        ++txMismatch;
+    }
+    txMismatch += consumeCheck(client, start+NUM_TEST_TX_DM+5, DM_RING_LEN);
+
+    // Tx ring notified through the write back descriptor, the stale AXI-Lite
+    // tail must not be used
+    xrt_mock::reset();
+    xrt_mock::state().registers[DM_REG_INDEX_TX_TAIL] = start;
+    xrt_mock::state().registers[DM_REG_INDEX_RX_HEAD] = start;
+    DataMoverClient clientWriteBack(device, uuid, "orderBookDataMoverTop");
+    clientWriteBack.start(0, 0, 2, 8);
+
+    kernelRespond(3);
+    if (0 != clientWriteBack.poll())
+    {
+        std::cout << "MISMATCH: poll used indexTxTail with write back enabled" << std::endl;
+        ++txMismatch;
+    }
+    memcpy(xrt_mock::device(4), &xrt_mock::state().registers[DM_REG_INDEX_TX_TAIL], sizeof(uint32_t));
+    ready = clientWriteBack.poll();
+    if (3 != ready)
+    {
+        std::cout << "MISMATCH: write back poll ready=" << ready << std::endl;
+        ++txMismatch;
+    }
+    txMismatch += consumeCheck(clientWriteBack, start, 3);
+
+    // Rx ring, fill against a stalled kernel head then release part of it
+    dataMoverOperation_t operation = {};
+    operation.opCode = 2;
+    operation.symbolIndex = 1;
+    operation.quantity = 100;
+    operation.price = 5000;
+    operation.direction = 1;
+    operation.origOrderId = 0xa5a5a5a5;
+
+    for (uint32_t i=0; i<DM_RING_LEN; i++)
+    {
+        operation.orderId = start + i;
+        operation.timestamp = i;
+        if (!clientWriteBack.push(operation))
+        {
+            std::cout << "MISMATCH: push " << i << " refused before ring full" << std::endl;
+            ++rxMismatch;
+        }
+    }
+    if (clientWriteBack.push(operation))
+    {
+        std::cout << "MISMATCH: push accepted on full ring" << std::endl;
+        ++rxMismatch;
+    }
+
+    // nothing reaches the kernel until flush, then the whole ring at once
+    if (start != xrt_mock::state().registers[DM_REG_INDEX_RX_TAIL])
+    {
+        std::cout << "MISMATCH: tail published before flush" << std::endl;
+        ++rxMismatch;
+    }
+    syncHeld = xrt_mock::state().syncCount;
+    clientWriteBack.flush();
+    if (((start+DM_RING_LEN) != xrt_mock::state().registers[DM_REG_INDEX_RX_TAIL]) ||
+        ((syncHeld+2) != xrt_mock::state().syncCount))
+    {
+        std::cout << "MISMATCH: flush tail=" << xrt_mock::state().registers[DM_REG_INDEX_RX_TAIL]
+                  << " syncs=" << (xrt_mock::state().syncCount - syncHeld) << std::endl;
+        ++rxMismatch;
+    }
+
+    // entries land in device memory in kernel pack order, the first slot
+    // after the wrap holds operation 8
+    uint8_t *entry = xrt_mock::device(3);
+    uint32_t orderId, origOrderId;
+    memcpy(&orderId, entry + 9, sizeof(orderId));
+    memcpy(&origOrderId, entry + 23, sizeof(origOrderId));
+    if ((1 != entry[0]) || (1 != entry[13]) || (2 != entry[14]) ||
+        ((start+8) != orderId) || (operation.origOrderId != origOrderId) || (8 != entry[15]))
+    {
+        std::cout << "MISMATCH: packed operation orderId=" << orderId << std::endl;
+        ++rxMismatch;
+    }
+
+    // kernel consumes 3, the client only then re-reads its head
+    xrt_mock::state().registers[DM_REG_INDEX_RX_HEAD] = start+3;
+    for (int i=0; i<3; i++)
+    {
+        if (!clientWriteBack.push(operation))
+        {
+            std::cout << "MISMATCH: push " << i << " refused after kernel head advanced" << std::endl;
+            ++rxMismatch;
+        }
+    }
+    if (clientWriteBack.push(operation))
+    {
+        std::cout << "MISMATCH: push accepted on full ring after release" << std::endl;
+        ++rxMismatch;
+    }
+    clientWriteBack.flush();
+    syncHeld = xrt_mock::state().syncCount;
+    clientWriteBack.flush();
+    if (((start+DM_RING_LEN+3) != xrt_mock::state().registers[DM_REG_INDEX_RX_TAIL]) ||
+        (syncHeld != xrt_mock::state().syncCount))
+    {
+        std::cout << "MISMATCH: flush after release tail=" << xrt_mock::state().registers[DM_REG_INDEX_RX_TAIL] << std::endl;
+        ++rxMismatch;
+    }
+
+    std::cout << "TX: checked " << (NUM_TEST_TX_DM + DM_RING_LEN + 5 + 3) << " responses, " << txMismatch << " mismatches" << std::endl;
+    std::cout << "RX: checked " << (DM_RING_LEN + 5) << " operations, " << rxMismatch << " mismatches" << std::endl;
+
+    std::cout << std::endl;
+    std::cout << "Done!" << std::endl;
+
+    return ((txMismatch + rxMismatch) != 0);
+}
@@ -0,0 +1 @@
+#include "xrt_mock.h"
@@ -0,0 +1,116 @@
+#ifndef XRT_MOCK_H
+#define XRT_MOCK_H
+
+// minimal stand in for the XRT native API used by DataMoverClient, lets the
+// client be unit tested without a device, buffers keep separate host and
+// device copies so only synced ranges are visible on either side
+
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+enum xclBOSyncDirection
+{
+    XCL_BO_SYNC_BO_TO_DEVICE = 0,
+    XCL_BO_SYNC_BO_FROM_DEVICE
+};
+
+namespace xrt_mock
+{
+
+typedef struct buffer_t
+{
+    std::vector<uint8_t> host;
+    std::vector<uint8_t> device;
+    uint64_t address;
+} buffer_t;
+
+typedef struct state_t
+{
+    std::map<uint32_t, uint32_t> registers;
+    std::map<int, std::shared_ptr<buffer_t> > buffers;   // by memory group
+    uint32_t syncCount;
+} state_t;
+
+inline state_t& state()
+{
+    static state_t s = {};
+    return s;
+}
+
+// kernel side view of the buffer allocated against a memory group
+inline uint8_t* device(int group)
+{
+    return state().buffers[group]->device.data();
+}
+
+inline void reset()
+{
+    state().registers.clear();
+    state().buffers.clear();
+    state().syncCount = 0;
+}
+
+}
+
+namespace xrt
+{
+
+class uuid {};
+
+class device {};
+
+class bo
+{
+public:
+
+    bo(const device&, size_t size, int group) : mBuffer(std::make_shared<xrt_mock::buffer_t>())
+    {
+        mBuffer->host.assign(size, 0);
+        mBuffer->device.assign(size, 0);
+        mBuffer->address = 0x1000000000ull * (group + 1);
+        xrt_mock::state().buffers[group] = mBuffer;
+    }
+
+    template <typename T>
+    T map() {return reinterpret_cast<T>(mBuffer->host.data());}
+
+    void sync(xclBOSyncDirection dir) {sync(dir, mBuffer->host.size(), 0);}
+
+    void sync(xclBOSyncDirection dir, size_t size, size_t offset)
+    {
+        ++xrt_mock::state().syncCount;
+        if (XCL_BO_SYNC_BO_TO_DEVICE == dir)
+            memcpy(mBuffer->device.data() + offset, mBuffer->host.data() + offset, size);
+        else
+            memcpy(mBuffer->host.data() + offset, mBuffer->device.data() + offset, size);
+    }
+
+    uint64_t address() const {return mBuffer->address;}
+
+private:
+
+    std::shared_ptr<xrt_mock::buffer_t> mBuffer;
+};
+
+class kernel
+{
+public:
+
+    enum class cu_access_mode {exclusive, shared};
+
+    kernel(const device&, const uuid&, const std::string&, cu_access_mode) {}
+
+    int group_id(int argno) const {return argno;}
+
+    uint32_t read_register(uint32_t offset) const {return xrt_mock::state().registers[offset];}
+
+    void write_register(uint32_t offset, uint32_t data) {xrt_mock::state().registers[offset] = data;}
+};
+
+}
+
+#endif
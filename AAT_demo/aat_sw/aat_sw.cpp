@@ -0,0 +1,208 @@
+#include "cmdlineparser.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <cstring>
+#include <vector>
+#include <chrono>
+#include <thread>
+
+#include "pipeline.hpp"
+#include "runtime.hpp"
+#include "pcap.hpp"
+
+#define NUM_PACKET           (54)
+#define NUM_FRAME_PER_PACKET (13)
+#define FEED_HIGH_WATER      (4096)	// feed words queued ahead of the workers
+
+// golden words hold the payload bytes most significant first
+static uint64_t byteReverse(uint64_t inputData)
+{
+    return __builtin_bswap64(inputData);
+}
+
+// one line per message, FIX printed as text with SOH shown as '|', binary
+// messages as hex
+static void writeMessage(std::ostream &out, const swMessage_t &message)
+{
+    bool text = (0 == message.payload.compare(0, 2, "8="));
+
+    out << std::dec << message.session << "," << message.payload.length() << ","
+        << std::hex << std::setw(4) << std::setfill('0') << message.sum << ",";
+    for (size_t i = 0; i < message.payload.length(); i++)
+    {
+        unsigned char c = message.payload[i];
+        if (text)
+        {
+            out << ((c == 0x01) ? '|' : (char)c);
+        }
+        else
+        {
+            out << std::setw(2) << (unsigned)c;
+        }
+    }
+    out << std::dec << std::setfill(' ') << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+    // Command Line Parser
+    sda::utils::CmdLineParser parser;
+
+    // Switches
+    //**************//"<Full Arg>",  "<Short Arg>", "<Description>", "<Default>"
+    parser.addSwitch("--pcap_file", "-p", "pcap capture to replay, compiled in golden packets if empty", "");
+    parser.addSwitch("--udp_port", "-u", "UDP destination port filter for the capture, 0 for any", "0");
+    parser.addSwitch("--output_file", "-o", "write each egress message to this file", "");
+    parser.addSwitch("--binary", "-b", "send orders with the binary protocol rather than FIX", "", true);
+    parser.addSwitch("--workers", "-w", "worker threads, 0 runs the stages in turn on this thread, all gives each stage its own", "0");
+    parser.addSwitch("--cores", "-c", "cores to pin workers to in order, e.g. 2-9, unpinned if empty", "");
+    parser.parse(argc, argv);
+
+    // Read settings
+    std::string pcapFile = parser.value("pcap_file");
+    uint16_t udpPort = stoi(parser.value("udp_port"));
+    std::string outputFile = parser.value("output_file");
+    bool binary = (parser.value("binary") == "true");
+    std::string workerValue = parser.value("workers");
+    bool threaded = (workerValue == "all") || (stoi(workerValue) > 0);
+    unsigned workers = (workerValue == "all") ? 0 : stoi(workerValue);
+    std::vector<int> cores;
+    if (!SwRuntime::parseCores(parser.value("cores"), cores))
+    {
+        std::cout << "ERROR: malformed core list " << parser.value("cores") << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    static SwPipeline pipeline;
+    pipeline.configure(binary ? OE_PROTOCOL_BINARY : 0);
+
+    std::cout << "Connecting order entry session ..." << std::endl;
+    if (!pipeline.connect())
+    {
+        std::cout << "ERROR: order entry session did not connect" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // packet source, a capture file when given, otherwise the golden packets
+    PcapReader pcap;
+    std::vector<uint8_t> goldenPayload(NUM_PACKET * NUM_FRAME_PER_PACKET * sizeof(uint64_t));
+    size_t goldenIndex = 0;
+    if (!pcapFile.empty())
+    {
+        if (!pcap.open(pcapFile, udpPort)) return EXIT_FAILURE;
+        std::cout << "Replay " << pcapFile << " (" << pcap.size() << " bytes)" << std::endl;
+    }
+    else
+    {
+        const uint64_t inputWords[NUM_PACKET][NUM_FRAME_PER_PACKET] =
+        {
+#include "input_golden.dat"
+        };
+
+        for (size_t n = 0; n < NUM_PACKET; n++)
+        {
+            for (size_t i = 0; i < NUM_FRAME_PER_PACKET; i++)
+            {
+                uint64_t word = byteReverse(inputWords[n][i]);
+                memcpy(&goldenPayload[((n * NUM_FRAME_PER_PACKET) + i) * sizeof(uint64_t)], &word, sizeof(uint64_t));
+            }
+        }
+    }
+    auto nextPacket = [&](pcapPacket_t &packet) -> bool {
+        if (!pcapFile.empty()) return pcap.next(packet);
+        if (goldenIndex >= NUM_PACKET) return false;
+        packet.timestamp = 0;
+        packet.length = NUM_FRAME_PER_PACKET * sizeof(uint64_t);
+        packet.data = &goldenPayload[goldenIndex * packet.length];
+        ++goldenIndex;
+        return true;
+    };
+
+    std::ofstream output;
+    if (!outputFile.empty())
+    {
+        output.open(outputFile);
+        if (!output)
+        {
+            std::cout << "ERROR: unable to open " << outputFile << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    uint64_t packets = 0, bytes = 0, messages = 0;
+    swMessage_t message;
+    auto collect = [&]() {
+        while (pipeline.nextMessage(message))
+        {
+            if (output.is_open()) writeMessage(output, message);
+            ++messages;
+        }
+    };
+
+    std::cout << "Replaying market data ..." << std::endl;
+    auto start = std::chrono::steady_clock::now();
+
+    pcapPacket_t packet;
+    if (!threaded)
+    {
+        // one packet is queued at a time so a full capture is never held in
+        // the model's streams, the next is pushed once the feed handler has
+        // taken every word of the last
+        while (nextPacket(packet))
+        {
+            pipeline.push(packet);
+            ++packets;
+            bytes += packet.length;
+            while (pipeline.pending() > 0)
+            {
+                pipeline.step();
+                collect();
+            }
+        }
+        pipeline.drain();
+        collect();
+    }
+    else
+    {
+        SwRuntime runtime(pipeline);
+        runtime.start(workers, cores);
+        runtime.describe(std::cout);
+
+        // keep the feed handler supplied without queueing the whole capture
+        while (nextPacket(packet))
+        {
+            while (pipeline.pending() > FEED_HIGH_WATER)
+            {
+                collect();
+                std::this_thread::yield();
+            }
+            pipeline.push(packet);
+            ++packets;
+            bytes += packet.length;
+            collect();
+        }
+        runtime.drain();
+        runtime.stop();
+        collect();
+    }
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (!pcapFile.empty())
+    {
+        std::cout << "Capture packets skipped: " << pcap.skipped() << std::endl;
+    }
+    std::cout << "Packets: " << packets << " (" << bytes << " bytes)" << std::endl;
+    std::cout << "Book operations: " << pipeline.feedStatus.txOperation << std::endl;
+    std::cout << "Book responses: " << pipeline.bookStatus.txResponse << std::endl;
+    std::cout << "Pricing operations: " << pipeline.pricingStatus.txOperation << std::endl;
+    std::cout << "Order entry messages: " << messages << " (" << pipeline.entryStatus.txDrop << " dropped)" << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "Elapsed: " << elapsed << " s, "
+              << ((elapsed > 0) ? ((packets / elapsed) / 1e6) : 0) << " Mpps, "
+              << ((elapsed > 0) ? ((pipeline.feedStatus.txOperation.to_uint64() / elapsed) / 1e6) : 0) << " M operations/s"
+              << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,36 @@
+#ifndef AP_AXI_SDATA_H
+#define AP_AXI_SDATA_H
+
+#include "ap_int.h"
+
+// Host build stand in for the Vitis HLS AXI4-Stream side channel types, the
+// kernels only use the data, keep, strb and last fields with no user, id or
+// dest sideband so those are left out
+template <int D, int U, int TI, int TD>
+struct ap_axiu
+{
+    ap_uint<D> data;
+    ap_uint<(D+7)/8> keep;
+    ap_uint<(D+7)/8> strb;
+    ap_uint<1> last;
+};
+
+template <int D, int U, int TI, int TD>
+struct ap_axis
+{
+    ap_int<D> data;
+    ap_uint<(D+7)/8> keep;
+    ap_uint<(D+7)/8> strb;
+    ap_uint<1> last;
+};
+
+template <int D, int U, int TI, int TD>
+struct qdma_axis
+{
+    ap_uint<D> data;
+    ap_uint<(D+7)/8> keep;
+    ap_uint<(D+7)/8> strb;
+    ap_uint<1> last;
+};
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef AP_SHIFT_REG_H
+#define AP_SHIFT_REG_H
+
+// Host build stand in for the Vitis HLS shift register, shift() returns the
+// element at addr before shifting in the new value
+template <typename T, unsigned N>
+class ap_shift_reg
+{
+public:
+
+    T shift(T value, unsigned addr=(N-1), bool enable=true)
+    {
+        T result = mData[addr];
+        if (enable)
+        {
+            for (unsigned i=(N-1); i>0; i--)
+            {
+                mData[i] = mData[i-1];
+            }
+            mData[0] = value;
+        }
+        return result;
+    }
+
+    T read(unsigned addr=(N-1)) const {return mData[addr];}
+
+private:
+
+    T mData[N];
+};
+
+#endif
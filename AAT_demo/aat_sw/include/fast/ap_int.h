@@ -0,0 +1,1100 @@
+#ifndef AP_INT_H
+#define AP_INT_H
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <type_traits>
+
+// Host build stand in for the Vitis HLS arbitrary precision integers, used in
+// place of the headers bundled with aat_host when the model is built with
+// AP_INT=fast. Values are held in native 64b words, a single word for widths
+// up to 64, and every operation is unrolled over a word count known at
+// compile time, so a part select on a 160b or 1024b bus is a shift and mask of
+// the one or two words it touches rather than a pass of the generic multiword
+// code in ap_private.
+//
+// Result widths and signedness follow the Vitis rules, as do the gcc style
+// comparisons between mixed sign operands, so the model gives the same output
+// with either set of headers. Only what the kernels use is provided, there is
+// no ap_fixed, division is limited to 128b and values print as decimal or 0x
+// prefixed hex.
+
+template <int _AP_W, bool _AP_S> struct ap_int_base;
+template <int _AP_W, bool _AP_S> struct ap_range_ref;
+template <int _AP_W, bool _AP_S> struct ap_bit_ref;
+template <int _AP_W> struct ap_concat_ref;
+template <int _AP_W> struct ap_int;
+template <int _AP_W> struct ap_uint;
+
+namespace ap_fast
+{
+
+constexpr int max(int a, int b) {return (a > b) ? a : b;}
+constexpr int min(int a, int b) {return (a < b) ? a : b;}
+constexpr int words(int w) {return (w + 63) / 64;}
+
+typedef unsigned __int128 uint128_t;
+typedef __int128 int128_t;
+
+// width and signedness an operand takes part in an expression with, C integer
+// types as ap_int/ap_uint of their own size, enums promote to int
+template <class T, class Enable = void>
+struct operand
+{
+    static constexpr int valid = 0, is_ap = 0, width = 1, sign = 0;
+};
+
+template <class T>
+struct operand<T, typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value>::type>
+{
+    static constexpr int valid = 1, is_ap = 0;
+    static constexpr int width = std::is_same<T, bool>::value ? 1 : (std::is_enum<T>::value ? 32 : (int)(sizeof(T) * 8));
+    static constexpr int sign = std::is_enum<T>::value || std::is_signed<T>::value;
+};
+
+template <int W, bool S>
+struct operand<ap_int_base<W, S> >
+{
+    static constexpr int valid = 1, is_ap = 1, width = W, sign = S;
+};
+
+template <int W>
+struct operand<ap_int<W> >
+{
+    static constexpr int valid = 1, is_ap = 1, width = W, sign = 1;
+};
+
+template <int W>
+struct operand<ap_uint<W> >
+{
+    static constexpr int valid = 1, is_ap = 1, width = W, sign = 0;
+};
+
+template <int W, bool S>
+struct operand<ap_range_ref<W, S> >
+{
+    static constexpr int valid = 1, is_ap = 1, width = W, sign = 0;
+};
+
+template <int W, bool S>
+struct operand<ap_bit_ref<W, S> >
+{
+    static constexpr int valid = 1, is_ap = 1, width = 1, sign = 0;
+};
+
+template <int W>
+struct operand<ap_concat_ref<W> >
+{
+    static constexpr int valid = 1, is_ap = 1, width = W, sign = 0;
+};
+
+// binary operators need at least one ap operand, anything else is left to
+// the built in operators through the integer conversion
+template <class A, class B>
+struct binary_enable
+{
+    static constexpr bool value = operand<A>::valid && operand<B>::valid &&
+                                  (operand<A>::is_ap || operand<B>::is_ap);
+};
+
+// result types, as RType in ap_int_base.h
+template <class A, class B, bool E = binary_enable<A, B>::value>
+struct binary {};
+
+template <class A, class B>
+struct binary<A, B, true>
+{
+    enum
+    {
+        W1 = operand<A>::width, S1 = operand<A>::sign,
+        W2 = operand<B>::width, S2 = operand<B>::sign,
+        mult_w = W1 + W2,
+        mult_s = S1 || S2,
+        plus_w = max(W1 + (S2 && !S1), W2 + (S1 && !S2)) + 1,
+        plus_s = S1 || S2,
+        minus_w = plus_w,
+        minus_s = true,
+        div_w = W1 + S2,
+        div_s = S1 || S2,
+        mod_w = min(W1, W2 + (!S2 && S1)),
+        mod_s = S1,
+        logic_w = max(W1 + (S2 && !S1), W2 + (S1 && !S2)),
+        logic_s = S1 || S2,
+        // equality is on the low bits of the wider width, at least 32, or on
+        // whole words for single word operands of the same width, ordering
+        // is on both extended one bit past the wider and then compared signed
+        // or unsigned by the gcc rules, division is on the same extension and
+        // signed as the wider operand
+        eq_w = ((W1 == W2) && (W1 <= 64)) ? 64 : max(max(W1, W2), 32),
+        rel_w = max(W1 + (S1 || S2), W2 + (S1 || S2)),
+        rel_s = (S1 == S2) ? S1 : ((W1 < 32) && (W2 < 32)) ? 1 : S1 ? (W2 < W1) : (W1 < W2),
+        div_op_s = (W1 > W2) ? S1 : (W2 > W1) ? S2 : (S1 || S2)
+    };
+
+    typedef ap_int_base<mult_w, mult_s> mult;
+    typedef ap_int_base<plus_w, plus_s> plus;
+    typedef ap_int_base<minus_w, minus_s> minus;
+    typedef ap_int_base<div_w, div_s> div;
+    typedef ap_int_base<mod_w, mod_s> mod;
+    typedef ap_int_base<logic_w, logic_s> logic;
+    typedef ap_concat_ref<W1 + W2> concat;
+};
+
+// low len bits set, 1 <= len <= 64
+inline uint64_t mask(int len)
+{
+    return ~0ull >> (64 - len);
+}
+
+// top word of a W bit value with the unused bits sign or zero extended
+template <int W, bool S>
+inline uint64_t fit(uint64_t v)
+{
+    const int excess = (words(W) * 64) - W;
+    return S ? (uint64_t)((int64_t)(v << excess) >> excess) : ((v << excess) >> excess);
+}
+
+// clear every bit from len upwards
+template <int N>
+inline void truncate(uint64_t *v, int len)
+{
+    for (int i = 0; i < N; i++)
+    {
+        int rem = len - (i * 64);
+        if (rem <= 0) v[i] = 0;
+        else if (rem < 64) v[i] &= mask(rem);
+    }
+}
+
+// n words holding bits [lo, lo+len) of src, zero extended
+inline void extract(uint64_t *out, int n, const uint64_t *src, int sn, int lo, int len)
+{
+    const int w = lo >> 6, s = lo & 63;
+    for (int i = 0; i < n; i++)
+    {
+        int rem = len - (i * 64);
+        uint64_t v = 0;
+        if (rem > 0)
+        {
+            int k = w + i;
+            v = src[k] >> s;
+            if (s && ((k + 1) < sn)) v |= src[k + 1] << (64 - s);
+            if (rem < 64) v &= mask(rem);
+        }
+        out[i] = v;
+    }
+}
+
+// write the low len bits of src to bits [lo, lo+len) of dst
+inline void deposit(uint64_t *dst, int dn, int lo, int len, const uint64_t *src)
+{
+    const int w = lo >> 6, s = lo & 63;
+    for (int i = 0, done = 0; done < len; i++, done += 64)
+    {
+        uint64_t m = mask(min(64, len - done));
+        uint64_t v = src[i] & m;
+        int k = w + i;
+        dst[k] = (dst[k] & ~(m << s)) | (v << s);
+        if (s && ((k + 1) < dn))
+        {
+            dst[k + 1] = (dst[k + 1] & ~(m >> (64 - s))) | (v >> (64 - s));
+        }
+    }
+}
+
+template <int N>
+inline void shl(uint64_t *v, int n)
+{
+    const int w = n >> 6, s = n & 63;
+    for (int i = N - 1; i >= 0; i--)
+    {
+        uint64_t x = (i >= w) ? (v[i - w] << s) : 0;
+        if (s && (i > w)) x |= v[i - w - 1] >> (64 - s);
+        v[i] = (n < (N * 64)) ? x : 0;
+    }
+}
+
+template <int N>
+inline void shr(uint64_t *v, int n, uint64_t fill)
+{
+    const int w = n >> 6, s = n & 63;
+    for (int i = 0; i < N; i++)
+    {
+        uint64_t lo = ((i + w) < N) ? v[i + w] : fill;
+        uint64_t hi = ((i + w + 1) < N) ? v[i + w + 1] : fill;
+        uint64_t x = s ? ((lo >> s) | (hi << (64 - s))) : lo;
+        v[i] = (n < (N * 64)) ? x : fill;
+    }
+}
+
+template <int N>
+inline void add(uint64_t *r, const uint64_t *a, const uint64_t *b)
+{
+    uint64_t carry = 0;
+    for (int i = 0; i < N; i++)
+    {
+        uint64_t t = a[i] + carry;
+        carry = (t < carry);
+        uint64_t x = t + b[i];
+        carry += (x < t);
+        r[i] = x;
+    }
+}
+
+template <int N>
+inline void sub(uint64_t *r, const uint64_t *a, const uint64_t *b)
+{
+    uint64_t borrow = 0;
+    for (int i = 0; i < N; i++)
+    {
+        uint64_t x = a[i], y = b[i];
+        r[i] = x - y - borrow;
+        borrow = (x < y) || ((x == y) && borrow);
+    }
+}
+
+template <int N>
+inline void mul(uint64_t *r, const uint64_t *a, const uint64_t *b)
+{
+    if (N == 1)
+    {
+        r[0] = a[0] * b[0];
+    }
+    else if (N == 2)
+    {
+        uint128_t p = (((uint128_t)a[N - 1] << 64) | a[0]) * (((uint128_t)b[N - 1] << 64) | b[0]);
+        r[0] = (uint64_t)p;
+        r[N - 1] = (uint64_t)(p >> 64);
+    }
+    else
+    {
+        uint64_t t[N] = {0};
+        for (int i = 0; i < N; i++)
+        {
+            uint64_t carry = 0;
+            for (int j = 0; (i + j) < N; j++)
+            {
+                uint128_t p = ((uint128_t)a[i] * b[j]) + t[i + j] + carry;
+                t[i + j] = (uint64_t)p;
+                carry = (uint64_t)(p >> 64);
+            }
+        }
+        memcpy(r, t, sizeof(t));
+    }
+}
+
+template <int N>
+inline bool eq(const uint64_t *a, const uint64_t *b)
+{
+    bool result = true;
+    for (int i = 0; i < N; i++)
+    {
+        result = result && (a[i] == b[i]);
+    }
+    return result;
+}
+
+template <int N>
+inline bool lt(const uint64_t *a, const uint64_t *b, bool sign)
+{
+    if (a[N - 1] != b[N - 1])
+    {
+        return sign ? ((int64_t)a[N - 1] < (int64_t)b[N - 1]) : (a[N - 1] < b[N - 1]);
+    }
+    for (int i = N - 2; i >= 0; i--)
+    {
+        if (a[i] != b[i]) return (a[i] < b[i]);
+    }
+    return false;
+}
+
+// n words of an operand's value, sign or zero extended by its own type
+template <class T>
+inline typename std::enable_if<operand<T>::valid && !operand<T>::is_ap>::type
+load(uint64_t *out, int n, const T &op)
+{
+    uint64_t v = operand<T>::sign ? (uint64_t)(int64_t)op : (uint64_t)op;
+    uint64_t fill = (operand<T>::sign && ((int64_t)v < 0)) ? ~0ull : 0;
+    out[0] = v;
+    for (int i = 1; i < n; i++)
+    {
+        out[i] = fill;
+    }
+}
+
+template <int W, bool S>
+inline void load(uint64_t *out, int n, const ap_int_base<W, S> &op)
+{
+    const int N = words(W);
+    uint64_t fill = S ? (uint64_t)((int64_t)op.V[N - 1] >> 63) : 0;
+    for (int i = 0; i < n; i++)
+    {
+        out[i] = (i < N) ? op.V[i] : fill;
+    }
+}
+
+template <int W, bool S>
+inline void load(uint64_t *out, int n, const ap_range_ref<W, S> &op)
+{
+    op.load(out, n);
+}
+
+template <int W, bool S>
+inline void load(uint64_t *out, int n, const ap_bit_ref<W, S> &op)
+{
+    out[0] = op.get();
+    for (int i = 1; i < n; i++)
+    {
+        out[i] = 0;
+    }
+}
+
+template <int W>
+inline void load(uint64_t *out, int n, const ap_concat_ref<W> &op)
+{
+    load(out, n, op.val);
+}
+
+// bit length as concatenated, part selects and concatenations by their
+// runtime length rather than the width of their type
+template <class T>
+inline typename std::enable_if<!operand<T>::is_ap, int>::type length(const T &)
+{
+    return operand<T>::width;
+}
+
+template <int W, bool S>
+inline int length(const ap_int_base<W, S> &) {return W;}
+template <int W, bool S>
+inline int length(const ap_range_ref<W, S> &op) {return op.length();}
+template <int W, bool S>
+inline int length(const ap_bit_ref<W, S> &) {return 1;}
+template <int W>
+inline int length(const ap_concat_ref<W> &op) {return op.length();}
+
+template <class T>
+inline bool nonzero(const T &op)
+{
+    const int N = words(operand<T>::width);
+    uint64_t v[N];
+    uint64_t any = 0;
+    load(v, N, op);
+    for (int i = 0; i < N; i++)
+    {
+        any |= v[i];
+    }
+    return (any != 0);
+}
+
+// shift distance of a shift operand, negative values shift the other way
+template <class T>
+inline int64_t distance(const T &op)
+{
+    uint64_t v;
+    load(&v, 1, op);
+    if (!operand<T>::sign && ((int64_t)v < 0)) return INT64_MAX;
+    return (int64_t)v;
+}
+
+} // namespace ap_fast
+
+template <int _AP_W, bool _AP_S>
+struct ap_int_base
+{
+    enum {NW = ap_fast::words(_AP_W)};
+
+    static const int width = _AP_W;
+    static const bool sign_flag = _AP_S;
+
+    typedef typename std::conditional<_AP_S, long long, unsigned long long>::type RetType;
+
+    // words least significant first, the unused bits of the top word hold
+    // the sign or zero extension
+    uint64_t V[NW];
+
+    ap_int_base()
+    {
+        for (int i = 0; i < NW; i++)
+        {
+            V[i] = 0;
+        }
+    }
+
+    template <class T>
+    ap_int_base(const T &op, typename std::enable_if<ap_fast::operand<T>::valid>::type* = 0)
+    {
+        ap_fast::load(V, NW, op);
+        normalize();
+    }
+
+    // truncated toward zero, as a cast to a C integer
+    ap_int_base(double op)
+    {
+        int64_t v = (op < 0) ? (int64_t)op : (int64_t)(uint64_t)op;
+        ap_fast::load(V, NW, v);
+        normalize();
+    }
+
+    ap_int_base(const char *str, signed char radix=10)
+    {
+        fromString(str, radix);
+    }
+
+    void normalize()
+    {
+        V[NW - 1] = ap_fast::fit<_AP_W, _AP_S>(V[NW - 1]);
+    }
+
+    /* Conversion
+     * ----------------------------------------------------------------
+     */
+    operator RetType() const {return (RetType)V[0];}
+
+    int to_int() const {return (int)V[0];}
+    unsigned to_uint() const {return (unsigned)V[0];}
+    long to_long() const {return (long)V[0];}
+    unsigned long to_ulong() const {return (unsigned long)V[0];}
+    long long to_int64() const {return (long long)V[0];}
+    unsigned long long to_uint64() const {return (unsigned long long)V[0];}
+    bool to_bool() const {return !iszero();}
+
+    int length() const {return _AP_W;}
+
+    bool iszero() const
+    {
+        uint64_t any = 0;
+        for (int i = 0; i < NW; i++)
+        {
+            any |= V[i];
+        }
+        return (any == 0);
+    }
+
+    std::string to_string(unsigned char radix=2, bool sign=_AP_S) const
+    {
+        uint64_t v[NW];
+        std::string digits, prefix;
+        bool negative = sign && ((int64_t)V[NW - 1] < 0);
+
+        memcpy(v, V, sizeof(v));
+        if (negative)
+        {
+            uint64_t zero[NW] = {0};
+            ap_fast::sub<NW>(v, zero, v);
+        }
+        else
+        {
+            ap_fast::truncate<NW>(v, _AP_W);
+        }
+
+        uint64_t left;
+        do
+        {
+            // divide the magnitude by the radix a word at a time
+            uint64_t rem = 0;
+            left = 0;
+            for (int i = NW - 1; i >= 0; i--)
+            {
+                ap_fast::uint128_t x = ((ap_fast::uint128_t)rem << 64) | v[i];
+                v[i] = (uint64_t)(x / radix);
+                rem = (uint64_t)(x % radix);
+                left |= v[i];
+            }
+            digits.insert(digits.begin(), "0123456789abcdef"[rem]);
+        } while (left != 0);
+
+        // a leading zero keeps the top digit from reading as a sign bit when
+        // it does not hold the top bit of the type
+        int bits = (radix == 16) ? 4 : (radix == 8) ? 3 : 1;
+        if ((radix != 10) && (((int)digits.size() * bits) < _AP_W) &&
+            ((digits[0] - ((digits[0] > '9') ? ('a' - 10) : '0')) >= (radix / 2)))
+        {
+            digits.insert(digits.begin(), '0');
+        }
+
+        if (radix == 2) prefix = "0b";
+        else if (radix == 8) prefix = "0o";
+        else if (radix == 16) prefix = "0x";
+        return (negative ? "-" : "") + prefix + digits;
+    }
+
+    /* Bit and part select
+     * ----------------------------------------------------------------
+     */
+    ap_range_ref<_AP_W, _AP_S> range(int Hi, int Lo) const
+    {
+        return ap_range_ref<_AP_W, _AP_S>(const_cast<ap_int_base*>(this), Hi, Lo);
+    }
+
+    ap_range_ref<_AP_W, _AP_S> range() const
+    {
+        return range(_AP_W - 1, 0);
+    }
+
+    ap_range_ref<_AP_W, _AP_S> operator()(int Hi, int Lo) const
+    {
+        return range(Hi, Lo);
+    }
+
+    ap_bit_ref<_AP_W, _AP_S> operator[](int index) const
+    {
+        return ap_bit_ref<_AP_W, _AP_S>(const_cast<ap_int_base*>(this), index);
+    }
+
+    /* Unary
+     * ----------------------------------------------------------------
+     */
+    ap_int_base operator~() const
+    {
+        ap_int_base r;
+        for (int i = 0; i < NW; i++)
+        {
+            r.V[i] = ~V[i];
+        }
+        r.normalize();
+        return r;
+    }
+
+    ap_int_base operator+() const {return *this;}
+
+    // -x is 0 - x with the usual result type, one bit wider and signed
+    ap_int_base<_AP_W + 1, true> operator-() const
+    {
+        ap_int_base<_AP_W + 1, true> r(*this);
+        uint64_t zero[ap_int_base<_AP_W + 1, true>::NW] = {0};
+        ap_fast::sub<ap_int_base<_AP_W + 1, true>::NW>(r.V, zero, r.V);
+        r.normalize();
+        return r;
+    }
+
+    bool operator!() const {return iszero();}
+
+    ap_int_base& operator++()
+    {
+        for (int i = 0; i < NW; i++)
+        {
+            if (++V[i] != 0) break;
+        }
+        normalize();
+        return *this;
+    }
+
+    ap_int_base& operator--()
+    {
+        for (int i = 0; i < NW; i++)
+        {
+            if (V[i]-- != 0) break;
+        }
+        normalize();
+        return *this;
+    }
+
+    ap_int_base operator++(int)
+    {
+        ap_int_base r(*this);
+        ++(*this);
+        return r;
+    }
+
+    ap_int_base operator--(int)
+    {
+        ap_int_base r(*this);
+        --(*this);
+        return r;
+    }
+
+    /* Shift by a signed distance, within the width of this type
+     * ----------------------------------------------------------------
+     */
+    void shift(int64_t n)
+    {
+        if (n >= 0)
+        {
+            ap_fast::shl<NW>(V, (n > (NW * 64)) ? (NW * 64) : (int)n);
+            normalize();
+        }
+        else
+        {
+            uint64_t fill = _AP_S ? (uint64_t)((int64_t)V[NW - 1] >> 63) : 0;
+            ap_fast::shr<NW>(V, (-n > (NW * 64)) ? (NW * 64) : (int)-n, fill);
+        }
+    }
+
+    /* Assignment with an operator, evaluated at the full result width and
+     * then truncated as in ap_int_base.h
+     * ----------------------------------------------------------------
+     */
+#define AP_FAST_ASSIGN_OP(ASSIGN_OP, OP)                                        \
+    template <class T>                                                          \
+    typename std::enable_if<ap_fast::operand<T>::valid, ap_int_base&>::type     \
+    operator ASSIGN_OP(const T &op)                                             \
+    {                                                                           \
+        *this = ap_int_base(*this OP op);                                       \
+        return *this;                                                           \
+    }
+
+    AP_FAST_ASSIGN_OP(+=, +)
+    AP_FAST_ASSIGN_OP(-=, -)
+    AP_FAST_ASSIGN_OP(*=, *)
+    AP_FAST_ASSIGN_OP(/=, /)
+    AP_FAST_ASSIGN_OP(%=, %)
+    AP_FAST_ASSIGN_OP(&=, &)
+    AP_FAST_ASSIGN_OP(|=, |)
+    AP_FAST_ASSIGN_OP(^=, ^)
+
+#undef AP_FAST_ASSIGN_OP
+
+    template <class T>
+    typename std::enable_if<ap_fast::operand<T>::valid, ap_int_base&>::type
+    operator<<=(const T &op)
+    {
+        shift(ap_fast::distance(op));
+        return *this;
+    }
+
+    template <class T>
+    typename std::enable_if<ap_fast::operand<T>::valid, ap_int_base&>::type
+    operator>>=(const T &op)
+    {
+        int64_t n = ap_fast::distance(op);
+        shift((n == INT64_MAX) ? -INT64_MAX : -n);
+        return *this;
+    }
+
+private:
+
+    void fromString(const char *str, int radix)
+    {
+        bool negative = false;
+
+        for (int i = 0; i < NW; i++)
+        {
+            V[i] = 0;
+        }
+
+        while (*str == ' ') ++str;
+        if (*str == '-')
+        {
+            negative = true;
+            ++str;
+        }
+        if ((str[0] == '0') && (str[1] != '\0'))
+        {
+            char p = str[1] | 0x20;
+            int prefixed = (p == 'x') ? 16 : (p == 'b') ? 2 : (p == 'o') ? 8 : 0;
+            if (prefixed && ((radix == 0) || (radix == prefixed)))
+            {
+                radix = prefixed;
+                str += 2;
+            }
+        }
+        if (radix == 0) radix = 10;
+
+        for (; *str != '\0'; ++str)
+        {
+            char c = *str | 0x20;
+            int digit = ((c >= '0') && (c <= '9')) ? (c - '0') : ((c >= 'a') && (c <= 'z')) ? (c - 'a' + 10) : radix;
+            if (digit >= radix) break;
+
+            uint64_t carry = digit;
+            for (int i = 0; i < NW; i++)
+            {
+                ap_fast::uint128_t x = ((ap_fast::uint128_t)V[i] * radix) + carry;
+                V[i] = (uint64_t)x;
+                carry = (uint64_t)(x >> 64);
+            }
+        }
+
+        if (negative)
+        {
+            uint64_t zero[NW] = {0};
+            ap_fast::sub<NW>(V, zero, V);
+        }
+        normalize();
+    }
+};
+
+template <int _AP_W, bool _AP_S>
+struct ap_range_ref
+{
+    enum {NW = ap_fast::words(_AP_W)};
+
+    ap_int_base<_AP_W, _AP_S> *d_bv;
+    int l_index;
+    int h_index;
+
+    ap_range_ref(ap_int_base<_AP_W, _AP_S> *bv, int h, int l)
+        : d_bv(bv), l_index(l), h_index(h)
+    {
+        assert((h >= 0) && (h < _AP_W) && (l >= 0) && (l < _AP_W));
+    }
+
+    int length() const
+    {
+        return (h_index >= l_index) ? (h_index - l_index + 1) : (l_index - h_index + 1);
+    }
+
+    // a range with Hi below Lo selects the bits in reverse order
+    void load(uint64_t *out, int n) const
+    {
+        if (h_index >= l_index)
+        {
+            ap_fast::extract(out, n, d_bv->V, NW, l_index, h_index - l_index + 1);
+        }
+        else
+        {
+            for (int i = 0; i < n; i++)
+            {
+                out[i] = 0;
+            }
+            for (int i = 0; (i <= (l_index - h_index)) && (i < (n * 64)); i++)
+            {
+                out[i >> 6] |= ((d_bv->V[(l_index - i) >> 6] >> ((l_index - i) & 63)) & 1) << (i & 63);
+            }
+        }
+    }
+
+    template <class T>
+    typename std::enable_if<ap_fast::operand<T>::valid, ap_range_ref&>::type
+    operator=(const T &op)
+    {
+        set(op);
+        return *this;
+    }
+
+    ap_range_ref& operator=(const ap_range_ref &op)
+    {
+        set(op);
+        return *this;
+    }
+
+    ap_int_base<_AP_W, false> get() const {return ap_int_base<_AP_W, false>(*this);}
+
+    operator unsigned long long() const {return to_uint64();}
+
+    unsigned long long to_uint64() const
+    {
+        uint64_t v;
+        load(&v, 1);
+        return v;
+    }
+
+    long long to_int64() const {return (long long)to_uint64();}
+    int to_int() const {return (int)to_uint64();}
+    unsigned to_uint() const {return (unsigned)to_uint64();}
+    bool to_bool() const {return !get().iszero();}
+
+private:
+
+    template <class T>
+    void set(const T &op)
+    {
+        int len = length();
+        if (h_index >= l_index)
+        {
+            if (len <= 64)
+            {
+                uint64_t v;
+                ap_fast::load(&v, 1, op);
+                ap_fast::deposit(d_bv->V, NW, l_index, len, &v);
+            }
+            else
+            {
+                uint64_t v[NW];
+                ap_fast::load(v, NW, op);
+                ap_fast::deposit(d_bv->V, NW, l_index, len, v);
+            }
+        }
+        else
+        {
+            uint64_t v[NW];
+            ap_fast::load(v, NW, op);
+            for (int i = 0; i < len; i++)
+            {
+                int b = l_index - i;
+                uint64_t bit = (v[i >> 6] >> (i & 63)) & 1;
+                d_bv->V[b >> 6] = (d_bv->V[b >> 6] & ~(1ull << (b & 63))) | (bit << (b & 63));
+            }
+        }
+        d_bv->normalize();
+    }
+};
+
+template <int _AP_W, bool _AP_S>
+struct ap_bit_ref
+{
+    ap_int_base<_AP_W, _AP_S> *d_bv;
+    int d_index;
+
+    ap_bit_ref(ap_int_base<_AP_W, _AP_S> *bv, int index)
+        : d_bv(bv), d_index(index)
+    {
+        assert((index >= 0) && (index < _AP_W));
+    }
+
+    bool get() const {return (d_bv->V[d_index >> 6] >> (d_index & 63)) & 1;}
+
+    operator bool() const {return get();}
+
+    bool to_bool() const {return get();}
+    int length() const {return 1;}
+
+    bool operator~() const {return !get();}
+
+    // any non zero value sets the bit
+    template <class T>
+    typename std::enable_if<ap_fast::operand<T>::valid, ap_bit_ref&>::type
+    operator=(const T &op)
+    {
+        set(ap_fast::nonzero(op));
+        return *this;
+    }
+
+    ap_bit_ref& operator=(const ap_bit_ref &op)
+    {
+        set(op.get());
+        return *this;
+    }
+
+private:
+
+    void set(bool value)
+    {
+        uint64_t &word = d_bv->V[d_index >> 6];
+        word = (word & ~(1ull << (d_index & 63))) | ((uint64_t)value << (d_index & 63));
+        d_bv->normalize();
+    }
+};
+
+// result of the concatenation operator, typed by the sum of the operand
+// widths but packed at their runtime lengths, as part selects may be narrower
+// than their type
+template <int _AP_W>
+struct ap_concat_ref
+{
+    ap_int_base<_AP_W, false> val;
+    int len;
+
+    int length() const {return len;}
+
+    ap_int_base<_AP_W, false> get() const {return val;}
+
+    operator unsigned long long() const {return val.to_uint64();}
+
+    unsigned long long to_uint64() const {return val.to_uint64();}
+    long long to_int64() const {return val.to_int64();}
+    int to_int() const {return val.to_int();}
+    unsigned to_uint() const {return val.to_uint();}
+};
+
+template <int _AP_W>
+struct ap_int : ap_int_base<_AP_W, true>
+{
+    typedef ap_int_base<_AP_W, true> Base;
+
+    ap_int() {}
+
+    template <class T>
+    ap_int(const T &op, typename std::enable_if<ap_fast::operand<T>::valid>::type* = 0) : Base(op) {}
+
+    ap_int(double op) : Base(op) {}
+
+    ap_int(const char *str, signed char radix=10) : Base(str, radix) {}
+};
+
+template <int _AP_W>
+struct ap_uint : ap_int_base<_AP_W, false>
+{
+    typedef ap_int_base<_AP_W, false> Base;
+
+    ap_uint() {}
+
+    template <class T>
+    ap_uint(const T &op, typename std::enable_if<ap_fast::operand<T>::valid>::type* = 0) : Base(op) {}
+
+    ap_uint(double op) : Base(op) {}
+
+    ap_uint(const char *str, signed char radix=10) : Base(str, radix) {}
+};
+
+/* Arithmetic and bitwise operators, both operands are brought to the result
+ * width and combined a word at a time
+ * ----------------------------------------------------------------
+ */
+#define AP_FAST_BINARY_OP(OP, RTYPE, BODY)                                      \
+template <class A, class B>                                                     \
+inline typename ap_fast::binary<A, B>::RTYPE operator OP(const A &a, const B &b) \
+{                                                                               \
+    typedef typename ap_fast::binary<A, B>::RTYPE R;                            \
+    R r(a), t(b);                                                               \
+    BODY;                                                                       \
+    r.normalize();                                                              \
+    return r;                                                                   \
+}
+
+AP_FAST_BINARY_OP(+, plus, ap_fast::add<R::NW>(r.V, r.V, t.V))
+AP_FAST_BINARY_OP(-, minus, ap_fast::sub<R::NW>(r.V, r.V, t.V))
+AP_FAST_BINARY_OP(*, mult, ap_fast::mul<R::NW>(r.V, r.V, t.V))
+AP_FAST_BINARY_OP(&, logic, for (int i = 0; i < R::NW; i++) r.V[i] &= t.V[i])
+AP_FAST_BINARY_OP(|, logic, for (int i = 0; i < R::NW; i++) r.V[i] |= t.V[i])
+AP_FAST_BINARY_OP(^, logic, for (int i = 0; i < R::NW; i++) r.V[i] ^= t.V[i])
+
+#undef AP_FAST_BINARY_OP
+
+// division on 128b native integers, both operands are extended one bit past
+// the wider as in ap_private, the remainder is only signed with a signed
+// dividend
+#define AP_FAST_DIVIDE_OP(OP, RTYPE, SIGNED)                                    \
+template <class A, class B>                                                     \
+inline typename ap_fast::binary<A, B>::RTYPE operator OP(const A &a, const B &b) \
+{                                                                               \
+    typedef ap_fast::binary<A, B> T;                                            \
+    typedef typename T::RTYPE R;                                                \
+    static_assert(T::rel_w <= 128, "ap_int division is limited to 128b");      \
+    const int e = 128 - T::rel_w;                                               \
+    uint64_t x[2], y[2];                                                        \
+    ap_fast::uint128_t p, q, v;                                                 \
+    R r;                                                                        \
+    ap_fast::load(x, 2, a);                                                     \
+    ap_fast::load(y, 2, b);                                                     \
+    p = (((ap_fast::uint128_t)x[1] << 64) | x[0]) << e;                         \
+    q = (((ap_fast::uint128_t)y[1] << 64) | y[0]) << e;                         \
+    if (SIGNED)                                                                 \
+    {                                                                           \
+        v = (ap_fast::uint128_t)(((ap_fast::int128_t)p >> e) OP ((ap_fast::int128_t)q >> e)); \
+    }                                                                           \
+    else                                                                        \
+    {                                                                           \
+        v = (p >> e) OP (q >> e);                                               \
+    }                                                                           \
+    r.V[0] = (uint64_t)v;                                                       \
+    if (R::NW > 1) r.V[R::NW - 1] = (uint64_t)(v >> 64);                        \
+    r.normalize();                                                              \
+    return r;                                                                   \
+}
+
+AP_FAST_DIVIDE_OP(/, div, T::div_op_s)
+AP_FAST_DIVIDE_OP(%, mod, (T::S1 && T::div_op_s))
+
+#undef AP_FAST_DIVIDE_OP
+
+/* Equality and relational operators
+ * ----------------------------------------------------------------
+ */
+template <class A, class B>
+inline typename std::enable_if<ap_fast::binary_enable<A, B>::value, bool>::type
+operator==(const A &a, const B &b)
+{
+    typedef ap_fast::binary<A, B> T;
+    const int N = ap_fast::words(T::eq_w);
+    uint64_t x[N], y[N];
+    ap_fast::load(x, N, a);
+    ap_fast::load(y, N, b);
+    x[N - 1] = ap_fast::fit<T::eq_w, false>(x[N - 1]);
+    y[N - 1] = ap_fast::fit<T::eq_w, false>(y[N - 1]);
+    return ap_fast::eq<N>(x, y);
+}
+
+template <class A, class B>
+inline typename std::enable_if<ap_fast::binary_enable<A, B>::value, bool>::type
+operator!=(const A &a, const B &b)
+{
+    return !(a == b);
+}
+
+template <class A, class B>
+inline typename std::enable_if<ap_fast::binary_enable<A, B>::value, bool>::type
+operator<(const A &a, const B &b)
+{
+    typedef ap_fast::binary<A, B> T;
+    const int N = ap_fast::words(T::rel_w);
+    uint64_t x[N], y[N];
+    ap_fast::load(x, N, a);
+    ap_fast::load(y, N, b);
+    x[N - 1] = ap_fast::fit<T::rel_w, T::rel_s>(x[N - 1]);
+    y[N - 1] = ap_fast::fit<T::rel_w, T::rel_s>(y[N - 1]);
+    return ap_fast::lt<N>(x, y, T::rel_s);
+}
+
+template <class A, class B>
+inline typename std::enable_if<ap_fast::binary_enable<A, B>::value, bool>::type
+operator>(const A &a, const B &b)
+{
+    return (b < a);
+}
+
+template <class A, class B>
+inline typename std::enable_if<ap_fast::binary_enable<A, B>::value, bool>::type
+operator<=(const A &a, const B &b)
+{
+    return !(b < a);
+}
+
+template <class A, class B>
+inline typename std::enable_if<ap_fast::binary_enable<A, B>::value, bool>::type
+operator>=(const A &a, const B &b)
+{
+    return !(a < b);
+}
+
+/* Shift, the result keeps the type of the left operand
+ * ----------------------------------------------------------------
+ */
+template <class A, class B>
+inline typename std::enable_if<ap_fast::operand<A>::is_ap && ap_fast::operand<B>::valid,
+                               ap_int_base<ap_fast::operand<A>::width, ap_fast::operand<A>::sign> >::type
+operator<<(const A &a, const B &b)
+{
+    ap_int_base<ap_fast::operand<A>::width, ap_fast::operand<A>::sign> r(a);
+    r <<= b;
+    return r;
+}
+
+template <class A, class B>
+inline typename std::enable_if<ap_fast::operand<A>::is_ap && ap_fast::operand<B>::valid,
+                               ap_int_base<ap_fast::operand<A>::width, ap_fast::operand<A>::sign> >::type
+operator>>(const A &a, const B &b)
+{
+    ap_int_base<ap_fast::operand<A>::width, ap_fast::operand<A>::sign> r(a);
+    r >>= b;
+    return r;
+}
+
+/* Concatenation
+ * ----------------------------------------------------------------
+ */
+template <class A, class B>
+inline typename ap_fast::binary<A, B>::concat operator,(const A &a, const B &b)
+{
+    typedef typename ap_fast::binary<A, B>::concat R;
+    const int N = ap_fast::words(ap_fast::operand<A>::width + ap_fast::operand<B>::width);
+    int la = ap_fast::length(a), lb = ap_fast::length(b);
+    uint64_t t[N];
+    R r;
+
+    ap_fast::load(r.val.V, N, a);
+    ap_fast::truncate<N>(r.val.V, la);
+    ap_fast::shl<N>(r.val.V, lb);
+    ap_fast::load(t, N, b);
+    ap_fast::truncate<N>(t, lb);
+    for (int i = 0; i < N; i++)
+    {
+        r.val.V[i] |= t[i];
+    }
+    r.len = la + lb;
+    return r;
+}
+
+template <class T>
+inline typename std::enable_if<ap_fast::operand<T>::is_ap, std::ostream&>::type
+operator<<(std::ostream &os, const T &x)
+{
+    ap_int_base<ap_fast::operand<T>::width, ap_fast::operand<T>::sign> v(x);
+    std::ios_base::fmtflags base = os.flags() & std::ios_base::basefield;
+    return os << v.to_string((base == std::ios_base::hex) ? 16 : (base == std::ios_base::oct) ? 8 : 10);
+}
+
+#endif
@@ -0,0 +1,196 @@
+#ifndef HLS_STREAM_H
+#define HLS_STREAM_H
+
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <thread>
+
+// Host build stand in for the Vitis HLS stream, enough of the hls::stream
+// interface for the kernel sources to compile and run unmodified on a CPU.
+//
+// Each stream is an unbounded lock-free single producer single consumer queue
+// of fixed size blocks, so a dataflow process may run on its own thread with
+// no locking, and full() is never asserted as in csim. The producer only
+// touches the tail block and the consumer the head block, a block is handed
+// over by publishing the write count after linking it.
+//
+// A read from an empty stream is reported and returns a default constructed
+// value as csim does, unless hls::sw::blocking() is set by a multithreaded
+// runtime, where it waits for the producer as the hardware would.
+namespace hls {
+
+namespace sw {
+
+inline std::atomic<bool>& blocking()
+{
+    static std::atomic<bool> flag(false);
+    return flag;
+}
+
+inline void relax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#else
+    std::this_thread::yield();
+#endif
+}
+
+}
+
+template <typename T>
+class stream
+{
+public:
+
+    stream() {init();}
+    explicit stream(const char *name) : mName(name) {init();}
+
+    stream(const stream&) = delete;
+    stream& operator=(const stream&) = delete;
+
+    ~stream()
+    {
+        while (mHead != nullptr)
+        {
+            block_t *next = mHead->next.load(std::memory_order_relaxed);
+            delete mHead;
+            mHead = next;
+        }
+    }
+
+    // consumer side
+
+    bool empty() const
+    {
+        if (mReadCount != mWriteCache) return false;
+        mWriteCache = mWriteCount.load(std::memory_order_acquire);
+        return (mReadCount == mWriteCache);
+    }
+
+    T read()
+    {
+        T value;
+        while (empty())
+        {
+            if (!sw::blocking().load(std::memory_order_relaxed))
+            {
+                std::cerr << "WARNING: read from empty stream '" << mName << "'" << std::endl;
+                return value;
+            }
+            sw::relax();
+        }
+        pop(value);
+        return value;
+    }
+
+    void read(T &value) {value = read();}
+
+    bool read_nb(T &value)
+    {
+        if (empty()) return false;
+        pop(value);
+        return true;
+    }
+
+    void operator>>(T &value) {read(value);}
+
+    // producer side
+
+    bool full() const {return false;}
+
+    void write(const T &value)
+    {
+        if (mTailIndex == BLOCK_LEN)
+        {
+            block_t *block = new block_t;
+            mTail->next.store(block, std::memory_order_relaxed);
+            mTail = block;
+            mTailIndex = 0;
+        }
+        mTail->slot[mTailIndex++] = value;
+        mWriteCount.store(mWriteCount.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    bool write_nb(const T &value)
+    {
+        write(value);
+        return true;
+    }
+
+    void operator<<(const T &value) {write(value);}
+
+    // either side, a snapshot while the other side is running
+
+    unsigned size() const
+    {
+        return (unsigned)(mWriteCount.load(std::memory_order_acquire) -
+                          mReadCountShared.load(std::memory_order_acquire));
+    }
+
+    // words written and read since construction, lets a runtime tell an idle
+    // pipeline from a busy one without reading kernel registers
+    uint64_t writes() const {return mWriteCount.load(std::memory_order_acquire);}
+    uint64_t reads() const {return mReadCountShared.load(std::memory_order_acquire);}
+
+private:
+
+    static const unsigned BLOCK_LEN = 256;
+    static const unsigned CACHE_LINE = 64;
+
+    typedef struct block_t
+    {
+        T slot[BLOCK_LEN];
+        std::atomic<block_t*> next;
+
+        block_t() : next(nullptr) {}
+    } block_t;
+
+    std::string mName;
+
+    // consumer
+    alignas(CACHE_LINE) block_t *mHead;
+    unsigned mHeadIndex;
+    uint64_t mReadCount;
+    mutable uint64_t mWriteCache;
+    std::atomic<uint64_t> mReadCountShared;
+
+    // producer
+    alignas(CACHE_LINE) block_t *mTail;
+    unsigned mTailIndex;
+    std::atomic<uint64_t> mWriteCount;
+
+    void init()
+    {
+        mHead = new block_t;
+        mTail = mHead;
+        mHeadIndex = 0;
+        mTailIndex = 0;
+        mReadCount = 0;
+        mWriteCache = 0;
+        mReadCountShared.store(0, std::memory_order_relaxed);
+        mWriteCount.store(0, std::memory_order_relaxed);
+    }
+
+    // caller has seen the stream non empty, so when the head block is used up
+    // the producer has already linked the next one
+    void pop(T &value)
+    {
+        if (mHeadIndex == BLOCK_LEN)
+        {
+            block_t *next = mHead->next.load(std::memory_order_relaxed);
+            delete mHead;
+            mHead = next;
+            mHeadIndex = 0;
+        }
+        value = mHead->slot[mHeadIndex++];
+        ++mReadCount;
+        mReadCountShared.store(mReadCount, std::memory_order_release);
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,505 @@
+#include "pipeline.hpp"
+
+#include <cstring>
+
+#define TCP_LISTEN_SUCCESS (0x1)
+#define TCP_SPACE          (0xffff)
+
+// egress trace ring, device memory on hardware, tracing is left disabled by
+// configure() but the port still needs backing
+static ap_uint<512> traceRing[OE_TRACE_RING_LEN*OE_TRACE_ENTRY_WORDS];
+
+// register files are plain structs of ap_uint whose default constructor
+// leaves the value unset, so a braced {} only runs those constructors,
+// value-initialise with () instead to zero every field
+SwPipeline::SwPipeline()
+    : feedControl(), feedStatus(), feedSymbols(), feedCapture(0),
+      bookControl(), bookStatus(), bookCapture(0),
+      pricingControl(), pricingStatus(), pricingCapture(0),
+      pricingStrategies(), pricingLegs(),
+      entryControl(), entryStatus(), entryCapture(0), entrySession(), entryTraceHead(0),
+      mTcpSessionID(0), mDataMoveResponses(0)
+{
+    addStages();
+}
+
+void SwPipeline::configure(uint32_t protocol)
+{
+    const uint32_t symbols[] = {0x11111111, 0x22222222, 0x33333333, 0x44444444, 0x55555555,
+                                0x66666666, 0x77777777, 0x88888888, 0x99999999, 0x12345678};
+
+    for (size_t i = 0; i < (sizeof(symbols)/sizeof(symbols[0])); i++)
+    {
+        feedSymbols.symbols[i] = symbols[i];
+    }
+    feedControl.tickInterval = OE_CLOCK_CYCLES_PER_MS; // 1ms of kernel clock
+
+    bookControl.control = 0x00000000;
+    bookControl.config = 0xdeadbeef;
+
+    pricingControl.control = 0x12345678;
+    pricingControl.config = 0xdeadbeef;
+    pricingControl.strategy = (PE_GLOBAL_STRATEGY | STRATEGY_PEG);
+    pricingControl.cacheWarmup = 1;
+
+    entryControl.control = (OE_TCP_GEN_SUM | OE_TCP_CONNECT);
+    entryControl.config = 0xdeadbeef;
+    entryControl.destAddress = 0x640aa8c0; // 192.168.10.100
+    entryControl.destPort = 0x17; // telnet (port 23)
+    entryControl.protocol = protocol;
+    entryControl.sendingDate = 0x20211201; // BCD YYYYMMDD
+    entryControl.sendingTime = (OE_TIME_LOAD | 0x093000); // BCD HHMMSS
+}
+
+bool SwPipeline::connect(unsigned maxSteps)
+{
+    for (unsigned i = 0; i < maxSteps; i++)
+    {
+        step();
+        if (entryStatus.sessionConnected.range(0,0)) return true;
+    }
+
+    return false;
+}
+
+void SwPipeline::push(const pcapPacket_t &packet)
+{
+    axiWordExt_t word;
+    uint32_t offset = 0;
+
+    // payload bytes in network order, first byte in [7:0] of the first word
+    word.strb = 0xff;
+    while (offset < packet.length)
+    {
+        uint32_t bytes = ((packet.length - offset) < 8) ? (packet.length - offset) : 8;
+        uint64_t data = 0;
+
+        memcpy(&data, packet.data + offset, bytes);
+        word.data = data;
+        word.keep = ((1 << bytes) - 1);
+        offset += bytes;
+        word.last = (offset == packet.length);
+        mFeedStream.write(word);
+    }
+}
+
+bool SwPipeline::step()
+{
+    uint64_t before = progress();
+
+    for (size_t i = 0; i < mStages.size(); i++)
+    {
+        mStages[i].run();
+    }
+
+    return (progress() != before);
+}
+
+void SwPipeline::drain(unsigned idleSteps)
+{
+    unsigned idle = 0;
+
+    while (idle < idleSteps)
+    {
+        idle = (step() || !mFeedStream.empty()) ? 0 : (idle + 1);
+    }
+}
+
+bool SwPipeline::nextMessage(swMessage_t &message)
+{
+    return mMessages.read_nb(message);
+}
+
+void SwPipeline::addStages()
+{
+    unsigned group = 0;
+
+    // feedHandlerTop
+    mStages.push_back({"udpPacketHandler", group++, [this]() {
+        mFeedHandler.udpPacketHandler(feedStatus.processWord,
+                                      feedStatus.processPacket,
+                                      mFeedStream,
+                                      mMdpDataFifo);
+    }});
+
+    mStages.push_back({"binaryPacketHandler", group++, [this]() {
+        mFeedHandler.binaryPacketHandler(feedStatus.processBinary,
+                                         mMdpDataFifo,
+                                         mFixMsgFifo,
+                                         mTemplateIdFifo);
+    }});
+
+    mStages.push_back({"fixDecoder", group++, [this]() {
+        mFeedHandler.fixDecoderTop(feedStatus.processFix,
+                                   mFixMsgFifo,
+                                   mTemplateIdFifo,
+                                   mSecurityIdFifo,
+                                   mFeedOperationFifo);
+    }});
+
+    mStages.push_back({"symbolLookup", group++, [this]() {
+        mFeedHandler.symbolLookup(feedControl.capture,
+                                  feedStatus.txOperation,
+                                  feedSymbols.symbols,
+                                  feedCapture,
+                                  mSecurityIdFifo,
+                                  mFeedOperationFifo,
+                                  mBookOperationStream);
+    }});
+
+    mStages.push_back({"eventHandler", group++, [this]() {
+        mFeedHandler.eventHandler(feedControl.tickInterval,
+                                  feedStatus.txEvent,
+                                  mEventStream);
+    }});
+
+    // orderBookTop
+    mStages.push_back({"bookOperationPull", group++, [this]() {
+        mOrderBook.operationPull(bookStatus.rxOperation,
+                                 mBookOperationStream,
+                                 mBookOperationFifo);
+    }});
+
+    mStages.push_back({"bookOperationProcess", group++, [this]() {
+        mOrderBook.operationProcess(bookStatus.processOperation,
+                                    bookStatus.invalidOperation,
+                                    bookStatus.generateResponse,
+                                    bookStatus.addOperation,
+                                    bookStatus.modifyOperation,
+                                    bookStatus.deleteOperation,
+                                    bookStatus.transactOperation,
+                                    bookStatus.haltOperation,
+                                    bookStatus.timestampError,
+                                    bookStatus.operationError,
+                                    bookStatus.symbolError,
+                                    bookStatus.directionError,
+                                    bookStatus.levelError,
+                                    mBookOperationFifo,
+                                    mBookResponseFifo);
+    }});
+
+    mStages.push_back({"bookResponsePush", group++, [this]() {
+        mOrderBook.responsePush(bookControl.control,
+                                bookControl.capture,
+                                bookStatus.txResponse,
+                                bookCapture,
+                                mBookResponseFifo,
+                                mBookResponseStream,
+                                mDataMoveStream);
+    }});
+
+    // pricingEngineTop
+    mStages.push_back({"pricingResponsePull", group++, [this]() {
+        mPricingEngine.responsePull(pricingControl.responseControl,
+                                    pricingStatus.rxResponse,
+                                    pricingStatus.conflateDefer,
+                                    pricingStatus.conflateDrop,
+                                    mBookResponseStream,
+                                    mPricingResponseFifo);
+    }});
+
+    mStages.push_back({"pricingEventPull", group++, [this]() {
+        mPricingEngine.eventPull(pricingStatus.rxEvent,
+                                 mEventStream,
+                                 mPricingEventFifo);
+    }});
+
+    mStages.push_back({"pricingFillPull", group++, [this]() {
+        mPricingEngine.fillPull(pricingStatus.rxFill,
+                                mFillStream,
+                                mPricingFillFifo);
+    }});
+
+    mStages.push_back({"pricingProcess", group++, [this]() {
+        mPricingEngine.pricingProcess(pricingControl.strategy,
+                                      pricingControl.cacheControl,
+                                      pricingControl.cacheWarmup,
+                                      pricingControl.quoteTimeInForce,
+                                      pricingControl.quoteHeartbeat,
+                                      pricingControl.paramCommit,
+                                      pricingControl.positionSelect,
+                                      pricingStatus.processResponse,
+                                      pricingStatus.strategyNone,
+                                      pricingStatus.strategyPeg,
+                                      pricingStatus.strategyLimit,
+                                      pricingStatus.strategyUnknown,
+                                      pricingStatus.strategySpread,
+                                      pricingStatus.cacheCold,
+                                      pricingStatus.quoteCancel,
+                                      pricingStatus.quoteRefresh,
+                                      pricingStatus.paramBank,
+                                      pricingStatus.paramCommit,
+                                      pricingStatus.fillTrade,
+                                      pricingStatus.fillUnknown,
+                                      pricingStatus.position,
+                                      pricingStrategies,
+                                      pricingLegs,
+                                      mPricingResponseFifo,
+                                      mPricingEventFifo,
+                                      mPricingFillFifo,
+                                      mPricingOperationFifo);
+    }});
+
+    mStages.push_back({"pricingOperationPush", group++, [this]() {
+        mPricingEngine.operationPush(pricingControl.capture,
+                                     pricingStatus.txOperation,
+                                     pricingCapture,
+                                     mPricingOperationFifo,
+                                     mEntryOperationStream);
+    }});
+
+    // orderEntryTcpTop, the session clock, connection state and transmit
+    // credit are OrderEntry members shared between processes so those
+    // processes are kept to one group
+    unsigned entrySessionGroup = group++;
+
+    mStages.push_back({"sendingTimeClock", entrySessionGroup, [this]() {
+        mOrderEntry.sendingTimeClock(entryControl.sendingDate,
+                                     entryControl.sendingTime);
+
+        // the load is edge triggered, drop it once the clock has seen it
+        entryControl.sendingTime = (entryControl.sendingTime & ~OE_TIME_LOAD);
+    }});
+
+    mStages.push_back({"openListenPortTcp", group++, [this]() {
+        mOrderEntry.openListenPortTcp(mListenPort,
+                                      mListenStatus);
+    }});
+
+    mStages.push_back({"openActivePortTcp", entrySessionGroup, [this]() {
+        mOrderEntry.openActivePortTcp(entryControl.control,
+                                      entryControl.destAddress,
+                                      entryControl.destPort,
+                                      entryStatus.debug,
+                                      entryStatus.sessionConnected,
+                                      entrySession.destAddress,
+                                      entrySession.destPort,
+                                      mOpenConnection,
+                                      mConnectionStatus,
+                                      mCloseConnection,
+                                      mTxStatus,
+                                      mSessionMapFifo);
+    }});
+
+    mStages.push_back({"entryOperationPull", group++, [this]() {
+        mOrderEntry.operationPull(entryControl.protocol,
+                                  entryStatus.rxOperation,
+                                  entrySession.route,
+                                  mEntryOperationStream,
+                                  mEntryHostStream,
+                                  mEntryOperationFifo,
+                                  mEntryCancelFifo,
+                                  mEntryTxFifo,
+                                  mEntryTxCancelFifo);
+    }});
+
+    mStages.push_back({"entryOperationEncode", group++, [this]() {
+        mOrderEntry.operationEncode(mEntryOperationFifo,
+                                    mEntryCancelFifo,
+                                    mEntryEncodeFifo,
+                                    mEntryEncodeCancelFifo);
+    }});
+
+    mStages.push_back({"entryOperationProcess", entrySessionGroup, [this]() {
+        mOrderEntry.operationProcessTcp(entryControl.control,
+                                        entryControl.capture,
+                                        entryStatus.processOperation,
+                                        entryStatus.txOrder,
+                                        entryStatus.txData,
+                                        entryStatus.txMeta,
+                                        entryStatus.txStatus,
+                                        entryStatus.txDrop,
+                                        entryStatus.txStall,
+                                        entryStatus.traceDrop,
+                                        entryCapture,
+                                        mEntryTxFifo,
+                                        mEntryTxCancelFifo,
+                                        mEntryEncodeFifo,
+                                        mEntryEncodeCancelFifo,
+                                        mTxMeta,
+                                        mTxData,
+                                        mTraceFifo);
+    }});
+
+    mStages.push_back({"messageTrace", group++, [this]() {
+        mOrderEntry.messageTrace(entryTraceHead,
+                                 entryStatus.traceTail,
+                                 traceRing,
+                                 mTraceFifo);
+    }});
+
+    mStages.push_back({"serverProcessTcp", group++, [this]() {
+        mOrderEntry.serverProcessTcp(entryControl.protocol,
+                                     entryStatus.rxData,
+                                     entryStatus.rxMeta,
+                                     mRxMeta,
+                                     mRxData,
+                                     mSessionMapFifo,
+                                     mExecReportFifo);
+    }});
+
+    mStages.push_back({"executionReportDecode", group++, [this]() {
+        mOrderEntry.executionReportDecode(entryStatus.rxFill,
+                                          mExecReportFifo,
+                                          mFillStream);
+    }});
+
+    mStages.push_back({"notificationHandlerTcp", group++, [this]() {
+        mOrderEntry.notificationHandlerTcp(entryStatus.notification,
+                                           entryStatus.readRequest,
+                                           mNotification,
+                                           mReadRequest);
+    }});
+
+    // stand ins for the network kernels and the data mover
+    mStages.push_back({"tcpOffload", group++, [this]() {
+        serviceTcp();
+    }});
+
+    mStages.push_back({"dataMoveSink", group++, [this]() {
+        orderBookResponsePack_t responsePack;
+        while (mDataMoveStream.read_nb(responsePack))
+        {
+            ++mDataMoveResponses;
+        }
+    }});
+
+    watch(mFeedStream);
+    watch(mBookOperationStream);
+    watch(mBookResponseStream);
+    watch(mDataMoveStream);
+    watch(mEventStream);
+    watch(mFillStream);
+    watch(mEntryOperationStream);
+    watch(mEntryHostStream);
+    watch(mMdpDataFifo);
+    watch(mFixMsgFifo);
+    watch(mTemplateIdFifo);
+    watch(mSecurityIdFifo);
+    watch(mFeedOperationFifo);
+    watch(mBookOperationFifo);
+    watch(mBookResponseFifo);
+    watch(mPricingResponseFifo);
+    watch(mPricingEventFifo);
+    watch(mPricingFillFifo);
+    watch(mPricingOperationFifo);
+    watch(mEntryOperationFifo);
+    watch(mEntryCancelFifo);
+    watch(mEntryEncodeFifo);
+    watch(mEntryEncodeCancelFifo);
+    watch(mEntryTxFifo);
+    watch(mEntryTxCancelFifo);
+    watch(mExecReportFifo);
+    watch(mSessionMapFifo);
+    watch(mTraceFifo);
+    watch(mListenPort);
+    watch(mListenStatus);
+    watch(mNotification);
+    watch(mReadRequest);
+    watch(mRxMeta);
+    watch(mRxData);
+    watch(mOpenConnection);
+    watch(mConnectionStatus);
+    watch(mCloseConnection);
+    watch(mTxMeta);
+    watch(mTxData);
+    watch(mTxStatus);
+}
+
+void SwPipeline::serviceTcp()
+{
+    ipTcpListenStatusPack_t listenStatusPack;
+    ipTcpConnectionStatusPack_t connectionStatusPack;
+    ipTcpTxStatusPack_t txStatusPack;
+    ipTcpTxMetaPack_t txMetaPack;
+    ipTcpTxDataPack_t txDataPack;
+
+    if (!mListenPort.empty())
+    {
+        mListenPort.read();
+        listenStatusPack.data = TCP_LISTEN_SUCCESS;
+        listenStatusPack.keep = 0x1;
+        listenStatusPack.last = 1;
+        mListenStatus.write(listenStatusPack);
+    }
+
+    // every open succeeds with the next session ID
+    if (!mOpenConnection.empty())
+    {
+        mOpenConnection.read();
+        ++mTcpSessionID;
+        connectionStatusPack.data = (0x10000 | mTcpSessionID);
+        connectionStatusPack.keep = 0xf;
+        connectionStatusPack.last = 1;
+        mConnectionStatus.write(connectionStatusPack);
+    }
+
+    while (!mCloseConnection.empty())
+    {
+        mCloseConnection.read();
+    }
+
+    // acknowledge each message in full as its metadata arrives, the reported
+    // space is constant so order entry credit only tracks bytes in flight
+    while (!mTxMeta.empty())
+    {
+        swMessage_t meta;
+
+        txMetaPack = mTxMeta.read();
+        meta.session = txMetaPack.data.range(15,0);
+        meta.sum = txMetaPack.data.range(47,32);
+        mMeta.push_back(meta);
+
+        txStatusPack.data = 0;
+        txStatusPack.data.range(15,0) = txMetaPack.data.range(15,0);  // sessionID
+        txStatusPack.data.range(31,16) = txMetaPack.data.range(31,16); // length
+        txStatusPack.data.range(61,32) = TCP_SPACE;
+        txStatusPack.data.range(63,62) = TXSTATUS_SUCCESS;
+        txStatusPack.keep = 0xff;
+        txStatusPack.last = 1;
+        mTxStatus.write(txStatusPack);
+    }
+
+    // payload is in network byte order, first byte in the lowest lane
+    while (!mTxData.empty())
+    {
+        txDataPack = mTxData.read();
+        for (int i = 0; i < OE_MSG_WORD_BYTES; i++)
+        {
+            if (txDataPack.keep.range(i,i))
+            {
+                mPayload += (char)(unsigned)txDataPack.data.range((i*8)+7,(i*8));
+            }
+        }
+
+        if (txDataPack.last)
+        {
+            swMessage_t message;
+            if (!mMeta.empty())
+            {
+                message = mMeta.front();
+                mMeta.pop_front();
+            }
+            else
+            {
+                message.session = 0;
+                message.sum = 0;
+            }
+            message.payload.swap(mPayload);
+            mMessages.write(message);
+            mPayload.clear();
+        }
+    }
+}
+
+uint64_t SwPipeline::progress() const
+{
+    uint64_t total = 0;
+
+    for (size_t i = 0; i < mProgress.size(); i++)
+    {
+        total += mProgress[i]();
+    }
+
+    return total;
+}
@@ -0,0 +1,192 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "feedhandler_kernels.hpp"
+#include "orderbook_kernels.hpp"
+#include "pricingengine_kernels.hpp"
+#include "orderentry_kernels.hpp"
+
+#include "pcap.hpp"
+
+// egress message as it would leave orderEntryTcpTop for the TCP kernel
+typedef struct swMessage_t
+{
+    uint16_t    session;  // TCP session ID
+    uint16_t    sum;      // partial checksum forwarded in the metadata
+    std::string payload;
+} swMessage_t;
+
+// one dataflow process, run() is a single pass of its II=1 body, stages
+// sharing a group touch the same kernel members and must run on one thread
+typedef struct swStage_t
+{
+    std::string name;
+    unsigned group;
+    std::function<void()> run;
+} swStage_t;
+
+/**
+ * Software model of the trading pipeline. The dataflow processes of each
+ * kernel top are wired here as in feedhandler_top.cpp, orderbook_top.cpp,
+ * pricingengine_top.cpp and orderentry_tcp_top.cpp, with the tops connected
+ * as in build/connect.cfg:
+ *
+ *   feedHandler -> orderBook -> pricingEngine -> orderEntry
+ *        |                         ^     ^           |
+ *        '----- clock ticks -------'     '-- fills --'
+ *
+ * A minimal TCP offload model stands in for ip_m/ip_s, it accepts the listen
+ * port and session open and returns transmit status for each message so
+ * order entry keeps its transmit credit. orderBookDataMoverTop is not
+ * modelled, book responses forwarded to the data mover are counted and
+ * discarded.
+ *
+ * step() runs every stage once in top order, the same as calling each top
+ * once. SwRuntime runs the stages on worker threads instead.
+ */
+class SwPipeline
+{
+public:
+
+    SwPipeline();
+
+    // load register configuration matching aat_host, protocol selects
+    // OE_PROTOCOL_BINARY for the order entry session
+    void configure(uint32_t protocol);
+
+    // step until the order entry session is up, false if it never connects
+    bool connect(unsigned maxSteps=1024);
+
+    // queue the UDP payload of a market data packet on the feed input
+    void push(const pcapPacket_t &packet);
+
+    // words still waiting on the feed input
+    unsigned pending() const {return mFeedStream.size();}
+
+    // run each stage once, true if any stream moved
+    bool step();
+
+    // step until idleSteps pass in a row with no progress
+    void drain(unsigned idleSteps=64);
+
+    // pop the next complete egress message
+    bool nextMessage(swMessage_t &message);
+
+    // words written and read across every stream, unchanged while idle
+    uint64_t progress() const;
+
+    const std::vector<swStage_t>& stages() const {return mStages;}
+
+    uint64_t dataMoveResponses() const {return mDataMoveResponses;}
+
+    // register files, exposed so callers can report kernel counters once the
+    // stages are no longer running
+    feedHandlerRegControl_t feedControl;
+    feedHandlerRegStatus_t feedStatus;
+    regSymbolMapContainer_t feedSymbols;
+    ap_uint<256> feedCapture;
+
+    orderBookRegControl_t bookControl;
+    orderBookRegStatus_t bookStatus;
+    ap_uint<1024> bookCapture;
+
+    pricingEngineRegControl_t pricingControl;
+    pricingEngineRegStatus_t pricingStatus;
+    ap_uint<1024> pricingCapture;
+    pricingEngineRegStrategy_t pricingStrategies[PE_NUM_PARAM_BANK][NUM_SYMBOL];
+    pricingEngineRegLegs_t pricingLegs[PE_NUM_PARAM_BANK][NUM_SYMBOL];
+
+    orderEntryRegControl_t entryControl;
+    orderEntryRegStatus_t entryStatus;
+    ap_uint<OE_MSG_CAPTURE_BITS> entryCapture;
+    orderEntryRegSessionContainer_t entrySession;
+    ap_uint<32> entryTraceHead;
+
+private:
+
+    FeedHandler mFeedHandler;
+    OrderBook mOrderBook;
+    PricingEngine mPricingEngine;
+    OrderEntry mOrderEntry;
+
+    // inter kernel streams, named after the connect.cfg ports they model
+    hls::stream<axiWordExt_t> mFeedStream;
+    hls::stream<orderBookOperationPack_t> mBookOperationStream;
+    hls::stream<orderBookResponsePack_t> mBookResponseStream;
+    hls::stream<orderBookResponsePack_t> mDataMoveStream;
+    hls::stream<clockTickGeneratorEvent_t> mEventStream;
+    hls::stream<orderEntryFillPack_t> mFillStream;
+    hls::stream<orderEntryOperationPack_t> mEntryOperationStream;
+    hls::stream<orderEntryOperationPack_t> mEntryHostStream;
+
+    // feedHandlerTop internal
+    hls::stream<axiWord_t> mMdpDataFifo;
+    hls::stream<axiWord_t> mFixMsgFifo;
+    hls::stream<templateId_t> mTemplateIdFifo;
+    hls::stream<securityId_t> mSecurityIdFifo;
+    hls::stream<orderBookOperation_t> mFeedOperationFifo;
+
+    // orderBookTop internal
+    hls::stream<orderBookOperation_t> mBookOperationFifo;
+    hls::stream<orderBookResponse_t> mBookResponseFifo;
+
+    // pricingEngineTop internal
+    hls::stream<orderBookResponse_t> mPricingResponseFifo;
+    hls::stream<ap_uint<8> > mPricingEventFifo;
+    hls::stream<orderEntryFill_t> mPricingFillFifo;
+    hls::stream<orderEntryOperation_t> mPricingOperationFifo;
+
+    // orderEntryTcpTop internal
+    hls::stream<orderEntryOperationEncode_t> mEntryOperationFifo;
+    hls::stream<orderEntryOperationEncode_t> mEntryCancelFifo;
+    hls::stream<orderEntryOperationEncode_t> mEntryEncodeFifo;
+    hls::stream<orderEntryOperationEncode_t> mEntryEncodeCancelFifo;
+    hls::stream<orderEntryOperationEncode_t> mEntryTxFifo;
+    hls::stream<orderEntryOperationEncode_t> mEntryTxCancelFifo;
+    hls::stream<orderEntryExecReport_t> mExecReportFifo;
+    hls::stream<orderEntrySessionMap_t> mSessionMapFifo;
+    hls::stream<orderEntryTraceEntry_t> mTraceFifo;
+
+    // order entry to TCP offload streams
+    hls::stream<ipTcpListenPortPack_t> mListenPort;
+    hls::stream<ipTcpListenStatusPack_t> mListenStatus;
+    hls::stream<ipTcpNotificationPack_t> mNotification;
+    hls::stream<ipTcpReadRequestPack_t> mReadRequest;
+    hls::stream<ipTcpRxMetaPack_t> mRxMeta;
+    hls::stream<ipTcpRxDataPack_t> mRxData;
+    hls::stream<ipTuplePack_t> mOpenConnection;
+    hls::stream<ipTcpConnectionStatusPack_t> mConnectionStatus;
+    hls::stream<ipTcpCloseConnectionPack_t> mCloseConnection;
+    hls::stream<ipTcpTxMetaPack_t> mTxMeta;
+    hls::stream<ipTcpTxDataPack_t> mTxData;
+    hls::stream<ipTcpTxStatusPack_t> mTxStatus;
+
+    // TCP model to host
+    hls::stream<swMessage_t> mMessages;
+
+    std::vector<swStage_t> mStages;
+    std::vector<std::function<uint64_t()> > mProgress;
+
+    uint16_t mTcpSessionID;
+    std::deque<swMessage_t> mMeta;     // metadata awaiting its payload
+    std::string mPayload;
+    uint64_t mDataMoveResponses;
+
+    void addStages();
+
+    void serviceTcp();
+
+    template <typename T>
+    void watch(hls::stream<T> &s)
+    {
+        mProgress.push_back([&s]() {return s.writes() + s.reads();});
+    }
+};
+
+#endif
@@ -0,0 +1,154 @@
+#include "runtime.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <pthread.h>
+#include <sched.h>
+
+SwRuntime::SwRuntime(SwPipeline &pipeline)
+    : mPipeline(pipeline), mRunning(false), mYield(false)
+{
+}
+
+SwRuntime::~SwRuntime()
+{
+    stop();
+}
+
+void SwRuntime::start(unsigned workers, const std::vector<int> &cores)
+{
+    const std::vector<swStage_t> &stages = mPipeline.stages();
+    std::vector<unsigned> groups;
+
+    stop();
+
+    // stage groups in pipeline order
+    for (size_t i = 0; i < stages.size(); i++)
+    {
+        bool found = false;
+        for (size_t g = 0; g < groups.size(); g++)
+        {
+            found = found || (groups[g] == stages[i].group);
+        }
+        if (!found) groups.push_back(stages[i].group);
+    }
+
+    if ((workers == 0) || (workers > groups.size())) workers = groups.size();
+
+    // contiguous runs of groups per worker keep neighbouring stages, and the
+    // streams between them, on the same core
+    mAssignment.assign(workers, std::vector<const swStage_t*>());
+    for (size_t g = 0; g < groups.size(); g++)
+    {
+        unsigned w = (g * workers) / groups.size();
+        for (size_t i = 0; i < stages.size(); i++)
+        {
+            if (stages[i].group == groups[g]) mAssignment[w].push_back(&stages[i]);
+        }
+    }
+
+    // spinning workers sharing a core only make progress if they give it up
+    mCores = cores;
+    mYield = (workers > std::thread::hardware_concurrency()) ||
+             (!cores.empty() && (workers > cores.size()));
+
+    hls::sw::blocking().store(true);
+    mRunning.store(true);
+    for (unsigned w = 0; w < workers; w++)
+    {
+        mThreads.push_back(std::thread(&SwRuntime::worker, this, w));
+    }
+}
+
+void SwRuntime::drain(unsigned idleMs)
+{
+    uint64_t last = mPipeline.progress();
+    unsigned idle = 0;
+
+    while (idle < idleMs)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        uint64_t now = mPipeline.progress();
+        idle = ((now == last) && (mPipeline.pending() == 0)) ? (idle + 1) : 0;
+        last = now;
+    }
+}
+
+void SwRuntime::stop()
+{
+    // release any worker waiting in a blocking read before joining
+    mRunning.store(false);
+    hls::sw::blocking().store(false);
+    for (size_t w = 0; w < mThreads.size(); w++)
+    {
+        mThreads[w].join();
+    }
+    mThreads.clear();
+}
+
+void SwRuntime::describe(std::ostream &out) const
+{
+    for (size_t w = 0; w < mAssignment.size(); w++)
+    {
+        out << "worker " << w;
+        if (!mCores.empty()) out << " (core " << mCores[w % mCores.size()] << ")";
+        out << ":";
+        for (size_t i = 0; i < mAssignment[w].size(); i++)
+        {
+            out << " " << mAssignment[w][i]->name;
+        }
+        out << std::endl;
+    }
+}
+
+bool SwRuntime::parseCores(const std::string &list, std::vector<int> &cores)
+{
+    std::stringstream ss(list);
+    std::string item;
+
+    cores.clear();
+    while (std::getline(ss, item, ','))
+    {
+        int first, last;
+        char dash;
+        std::stringstream range(item);
+
+        if (!(range >> first)) return false;
+        last = first;
+        if ((range >> dash) && ((dash != '-') || !(range >> last))) return false;
+        if ((first < 0) || (last < first)) return false;
+        for (int core = first; core <= last; core++)
+        {
+            cores.push_back(core);
+        }
+    }
+
+    return true;
+}
+
+void SwRuntime::worker(unsigned index)
+{
+    const std::vector<const swStage_t*> &stages = mAssignment[index];
+
+    if (!mCores.empty())
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(mCores[index % mCores.size()], &set);
+        if (0 != pthread_setaffinity_np(pthread_self(), sizeof(set), &set))
+        {
+            std::cerr << "WARNING: unable to pin worker " << index << " to core "
+                      << mCores[index % mCores.size()] << std::endl;
+        }
+    }
+
+    while (mRunning.load(std::memory_order_relaxed))
+    {
+        for (size_t i = 0; i < stages.size(); i++)
+        {
+            stages[i]->run();
+        }
+        if (mYield) std::this_thread::yield();
+    }
+}
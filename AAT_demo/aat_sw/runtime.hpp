@@ -0,0 +1,60 @@
+#ifndef RUNTIME_H
+#define RUNTIME_H
+
+#include <atomic>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "pipeline.hpp"
+
+/**
+ * Multithreaded runtime for SwPipeline, the dataflow stages run free on
+ * worker threads the way the processes of a DATAFLOW region run in parallel
+ * on the card, each optionally pinned to a core. Stages only share state
+ * through hls::stream, a lock-free single producer single consumer queue, so
+ * the workers need no locks. Stage groups are split over the workers in
+ * pipeline order, with a worker per group when enough threads are asked for.
+ *
+ * Register files are only safe to read once stop() has returned.
+ */
+class SwRuntime
+{
+public:
+
+    explicit SwRuntime(SwPipeline &pipeline);
+    ~SwRuntime();
+
+    // start workers threads, 0 for one per stage group, cores are assigned to
+    // workers in order and reused when there are fewer cores than workers,
+    // an empty list leaves scheduling to the OS
+    void start(unsigned workers, const std::vector<int> &cores);
+
+    // return once no stream has moved for idleMs and the feed input is empty
+    void drain(unsigned idleMs=10);
+
+    // stop and join the workers
+    void stop();
+
+    unsigned workers() const {return mAssignment.size();}
+
+    // worker to stage mapping, one line per worker
+    void describe(std::ostream &out) const;
+
+    // parse a core list such as "2,3,8-11", false if malformed
+    static bool parseCores(const std::string &list, std::vector<int> &cores);
+
+private:
+
+    SwPipeline &mPipeline;
+    std::vector<std::vector<const swStage_t*> > mAssignment;
+    std::vector<int> mCores;
+    std::vector<std::thread> mThreads;
+    std::atomic<bool> mRunning;
+    bool mYield;
+
+    void worker(unsigned index);
+};
+
+#endif
@@ -57,7 +57,8 @@ enum PRICINGENGINE_STRATEGIES
 {
     STRATEGY_NONE = 0,
     STRATEGY_PEG = 1,
-    STRATEGY_LIMIT = 2
+    STRATEGY_LIMIT = 2,
+    STRATEGY_SPREAD = 3
 };
 
 enum ORDERENTRY_OPCODES
@@ -67,6 +68,19 @@ enum ORDERENTRY_OPCODES
     ORDERENTRY_DELETE
 };
 
+// execution report ExecType (FIX tag 150), carried unchanged in fill events
+enum ORDERENTRY_EXEC_TYPES
+{
+    EXEC_NEW = '0',
+    EXEC_PARTIAL_FILL = '1',
+    EXEC_FILL = '2',
+    EXEC_CANCELED = '4',
+    EXEC_REPLACED = '5',
+    EXEC_REJECTED = '8',
+    EXEC_EXPIRED = 'C',
+    EXEC_TRADE = 'F'
+};
+
 enum TCP_TXSTATUS_CODES
 {
     TXSTATUS_SUCCESS = 0,
@@ -92,6 +92,7 @@ void mmInterface::orderEntryOperationPack(orderEntryOperation_t *src,
 {
 #pragma HLS INLINE
 
+    dest->data.range(215,184) = src->origOrderId;
     dest->data.range(183,120) = src->timestamp;
     dest->data.range(119,112) = src->opCode;
     dest->data.range(111,104) = src->symbolIndex;
@@ -108,6 +109,7 @@ void mmInterface::orderEntryOperationUnpack(orderEntryOperationPack_t *src,
 {
 #pragma HLS INLINE
 
+    dest->origOrderId = src->data.range(215,184);
     dest->timestamp   = src->data.range(183,120);
     dest->opCode      = src->data.range(119,112);
     dest->symbolIndex = src->data.range(111,104);
@@ -119,6 +121,32 @@ void mmInterface::orderEntryOperationUnpack(orderEntryOperationPack_t *src,
     return;
 }
 
+void mmInterface::orderEntryFillPack(orderEntryFill_t *src,
+                                     orderEntryFillPack_t *dest)
+{
+#pragma HLS INLINE
+
+    dest->data.range(103,72) = src->orderId;
+    dest->data.range(71,64)  = src->execType;
+    dest->data.range(63,32)  = src->quantity;
+    dest->data.range(31,0)   = src->price;
+
+    return;
+}
+
+void mmInterface::orderEntryFillUnpack(orderEntryFillPack_t *src,
+                                       orderEntryFill_t *dest)
+{
+#pragma HLS INLINE
+
+    dest->orderId  = src->data.range(103,72);
+    dest->execType = src->data.range(71,64);
+    dest->quantity = src->data.range(63,32);
+    dest->price    = src->data.range(31,0);
+
+    return;
+}
+
 void mmInterface::ipTuplePack(ipTuple_t *src,
                               ipTuplePack_t *dest)
 {
@@ -66,6 +66,7 @@ typedef struct orderEntryOperation_t
     ap_uint<32> quantity;
     ap_uint<32> price;
     ap_uint<8>  direction;
+    ap_uint<32> origOrderId; // order replaced or cancelled, zero for a new order
 } orderEntryOperation_t;
 
 typedef struct orderEntryOperationEncode_t
@@ -74,11 +75,24 @@ typedef struct orderEntryOperationEncode_t
     ap_uint<8>  opCode;
     ap_uint<8>  symbolIndex;
     ap_uint<80> orderId;
+    ap_uint<80> origOrderId;
     ap_uint<80> quantity;
-    ap_uint<80> price;
+    ap_uint<88> price;
     ap_uint<8>  direction;
+    ap_uint<8>  session;
+    ap_uint<1>  binary;
 } orderEntryOperationEncode_t;
 
+// execution report received on an order entry session, reduced to the
+// fields PricingEngine needs to track open orders and position
+typedef struct orderEntryFill_t
+{
+    ap_uint<32> orderId;  // ClOrdID (11)
+    ap_uint<8>  execType; // ExecType (150)
+    ap_uint<32> quantity; // LastQty (32)
+    ap_uint<32> price;    // LastPx (31)
+} orderEntryFill_t;
+
 typedef struct ipTuple_t
 {
     ap_uint<32> address;
@@ -229,8 +243,9 @@ typedef ap_uint<16> templateId_t;
 typedef ap_uint<32> securityId_t;
 typedef ap_axiu<224,0,0,0> orderBookOperationPack_t;
 typedef ap_axiu<1024,0,0,0> orderBookResponsePack_t;
-typedef ap_axiu<184,0,0,0> orderEntryOperationPack_t;
+typedef ap_axiu<216,0,0,0> orderEntryOperationPack_t;
 typedef ap_axiu<1024,0,0,0> orderEntryMessagePack_t;
+typedef ap_axiu<104,0,0,0> orderEntryFillPack_t;
 typedef ap_axiu<8,0,0,0> clockTickGeneratorEvent_t;
 
 // network facing packed data structures
@@ -279,6 +294,12 @@ public:
     void orderEntryOperationUnpack(orderEntryOperationPack_t *src,
                                    orderEntryOperation_t *dest);
 
+    void orderEntryFillPack(orderEntryFill_t *src,
+                            orderEntryFillPack_t *dest);
+
+    void orderEntryFillUnpack(orderEntryFillPack_t *src,
+                              orderEntryFill_t *dest);
+
     void ipTuplePack(ipTuple_t *src,
                      ipTuplePack_t *dest);
 
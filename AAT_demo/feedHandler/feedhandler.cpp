@@ -291,26 +291,35 @@ void FeedHandler::symbolLookup(ap_uint<32> &regCaptureControl,
     return;
 }
 
-void FeedHandler::eventHandler(ap_uint<32> &regRxEvent,
+void FeedHandler::eventHandler(ap_uint<32> &regTickInterval,
+                               ap_uint<32> &regTxEvent,
                                hls::stream<clockTickGeneratorEvent_t> &eventStream)
 {
 #pragma HLS PIPELINE II=1 style=flp
 
     clockTickGeneratorEvent_t tickEvent;
 
-    static ap_uint<32> countRxEvent=0;
+    static ap_uint<32> countCycle=0;
+    static ap_uint<32> countTxEvent=0;
 
-    if(!eventStream.empty())
+    // clock tick events are generated here on a programmable interval in
+    // kernel cycles and forwarded to PricingEngine to age resting quotes
+    // while the market is quiet, an interval of zero disables the ticks
+    if((0 != regTickInterval) && (countCycle >= (regTickInterval-1)))
     {
-        tickEvent = eventStream.read();
-        ++countRxEvent;
-
-        // event notification has been received from programmable clock tick
-        // generator, handling currently limited to incrementing a counter,
-        // placeholder for user to extend with custom event handling code
+        tickEvent.data = countTxEvent.range(7,0);
+        tickEvent.keep = 0x1;
+        tickEvent.last = 1;
+        eventStream.write(tickEvent);
+        ++countTxEvent;
+        countCycle = 0;
+    }
+    else
+    {
+        ++countCycle;
     }
 
-    regRxEvent = countRxEvent;
+    regTxEvent = countTxEvent;
 
     return;
 }
@@ -416,8 +425,6 @@ void FeedHandler::MDIncrementalRefreshBook32(axiWord_t &fixData,
     static axiWord_t prevData;
     static orderBookOperation_t operation;
 
-    static ap_uint<32> countTxOperation=0;
-
     switch(stateId)
     {
         case DECODE:
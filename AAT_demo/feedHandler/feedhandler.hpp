@@ -35,7 +35,7 @@ typedef struct feedHandlerRegControl_t
 {
     ap_uint<32> control;
     ap_uint<32> capture;
-    ap_uint<32> reserved02;
+    ap_uint<32> tickInterval;
     ap_uint<32> reserved03;
     ap_uint<32> reserved04;
     ap_uint<32> reserved05;
@@ -50,7 +50,7 @@ typedef struct feedHandlerRegStatus_t
     ap_uint<32> processBinary;
     ap_uint<32> processFix;
     ap_uint<32> txOperation;
-    ap_uint<32> rxEvent;
+    ap_uint<32> txEvent;
     ap_uint<32> reserved06;
     ap_uint<32> reserved07;
 } feedHandlerRegStatus_t;
@@ -97,7 +97,8 @@ public:
                       hls::stream<orderBookOperation_t> &operationStream,
                       hls::stream<orderBookOperationPack_t> &operationStreamPack);
 
-    void eventHandler(ap_uint<32> &regRxEvent,
+    void eventHandler(ap_uint<32> &regTickInterval,
+                      ap_uint<32> &regTxEvent,
                       hls::stream<clockTickGeneratorEvent_t> &eventStream);
 
 private:
@@ -24,6 +24,7 @@ extern "C" void feedHandlerTop(feedHandlerRegControl_t &regControl,
                                regSymbolMapContainer_t &regSymbolMap,
                                ap_uint<256> &regCapture,
                                hls::stream<axiWordExt_t> &inputDataFeed,
-                               hls::stream<orderBookOperationPack_t> &operationStreamPack);
+                               hls::stream<orderBookOperationPack_t> &operationStreamPack,
+                               hls::stream<clockTickGeneratorEvent_t> &eventStreamPack);
 
 #endif
@@ -21,7 +21,8 @@ extern "C" void feedHandlerTop(feedHandlerRegControl_t &regControl,
                                regSymbolMapContainer_t &regSymbolMap,
                                ap_uint<256> &regCapture,
                                hls::stream<axiWordExt_t> &inputDataStream,
-                               hls::stream<orderBookOperationPack_t> &operationStreamPack)
+                               hls::stream<orderBookOperationPack_t> &operationStreamPack,
+                               hls::stream<clockTickGeneratorEvent_t> &eventStreamPack)
 {
 #pragma HLS INTERFACE s_axilite port=regControl bundle=control
 #pragma HLS INTERFACE s_axilite port=regStatus bundle=control
@@ -33,6 +34,7 @@ extern "C" void feedHandlerTop(feedHandlerRegControl_t &regControl,
 #pragma HLS INTERFACE ap_none port=regCapture
 #pragma HLS INTERFACE axis port=inputDataStream depth=32
 #pragma HLS INTERFACE axis port=operationStreamPack depth=32
+#pragma HLS INTERFACE axis port=eventStreamPack
 #pragma HLS INTERFACE ap_ctrl_none port=return
 
     static hls::stream<axiWord_t> mdpDataFifo;
@@ -77,4 +79,8 @@ extern "C" void feedHandlerTop(feedHandlerRegControl_t &regControl,
                         securityIdFifo,
                         operationFifo,
                         operationStreamPack);
+
+    kernel.eventHandler(regControl.tickInterval,
+                        regStatus.txEvent,
+                        eventStreamPack);
 }
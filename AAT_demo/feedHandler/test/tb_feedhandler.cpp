@@ -22,6 +22,7 @@
 
 #define NUM_PACKET           (54)
 #define NUM_FRAME_PER_PACKET (13)
+#define NUM_TEST_TICK_FH     (16) // kernel calls between clock tick events
 
 // TODO: templated byteReverse function for various widths in common
 ap_uint<64> byteReverse(ap_uint<64> inputData)
@@ -49,9 +50,14 @@ int main()
     axiWordExt_t axiw;
     orderBookOperation_t operation;
     orderBookOperationPack_t operationPack;
+    clockTickGeneratorEvent_t tickEvent;
+    unsigned countCall=0;
+    unsigned tickCount=0;
+    unsigned tickMismatch=0;
 
     hls::stream<axiWordExt_t> inputDataStream;
     hls::stream<orderBookOperationPack_t> operationStreamPack;
+    hls::stream<clockTickGeneratorEvent_t> eventStreamPack;
 
     std::cout << "FeedHandler Test" << std::endl;
     std::cout << "----------------" << std::endl;
@@ -70,6 +76,7 @@ int main()
 
     // configure
     regControl.control = 0x00000000;
+    regControl.tickInterval = NUM_TEST_TICK_FH;
 
     // symbol map load
     regSymbolContainer.symbols[0] = 0x11111111;
@@ -106,20 +113,24 @@ int main()
                            regSymbolContainer,
                            regCapture,
                            inputDataStream,
-                           operationStreamPack);
+                           operationStreamPack,
+                           eventStreamPack);
+            ++countCall;
         }
     }
 
     // this seems to be required to flush the pipeline and get the final response
     // without it "WARNING: Hls::stream 'udpDataFifo' contains leftover data" is reported
-    for(int i; i<64; i++)
+    for(int i=0; i<64; i++)
     {
         feedHandlerTop(regControl,
                        regStatus,
                        regSymbolContainer,
                        regCapture,
                        inputDataStream,
-                       operationStreamPack);
+                       operationStreamPack,
+                       eventStreamPack);
+        ++countCall;
     }
 
     // drain
@@ -140,6 +151,24 @@ int main()
                   << operation.level << std::endl;
     }
 
+    // one tick per interval of kernel calls, numbered in order
+    while(!eventStreamPack.empty())
+    {
+        tickEvent = eventStreamPack.read();
+        if(tickEvent.data != (tickCount & 0xff))
+        {
+            std::cout << "MISMATCH: tick event " << tickCount << std::endl;
+            ++tickMismatch;
+        }
+        ++tickCount;
+    }
+
+    if((tickCount != (countCall / NUM_TEST_TICK_FH)) || (tickCount != regStatus.txEvent))
+    {
+        std::cout << "MISMATCH: tick count " << tickCount << std::endl;
+        ++tickMismatch;
+    }
+
     // log final status
     std::cout << "--" << std::hex << std::endl;
     std::cout << "STATUS: ";
@@ -148,8 +177,9 @@ int main()
     std::cout << "FH_PROCESS_BINARY=" << regStatus.processBinary << " ";
     std::cout << "FH_PROCESS_FIX=" << regStatus.processFix << " ";
     std::cout << "FH_TX_OP=" << regStatus.txOperation << " ";
-    std::cout << "FH_RX_EVENT=" << regStatus.rxEvent << " ";
+    std::cout << "FH_TX_EVENT=" << regStatus.txEvent << " ";
     std::cout << std::endl;
+    std::cout << std::dec << "TICK: checked " << tickCount << " events, " << tickMismatch << " mismatches" << std::endl;
 
     std::cout << std::endl;
     std::cout << "Done!" << std::endl;
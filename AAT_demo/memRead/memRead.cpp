@@ -17,20 +17,61 @@
 #include <ap_int.h>
 #include <hls_stream.h>
 
-extern "C" {
-void memRead(ap_uint<64>* mem, int size, hls::stream<ap_axiu<64,0,0,0> >& stream) {
-	
-	#pragma HLS INTERFACE axis register port=stream depth=32
-	
+#define MEM_WORDS_PER_BEAT  (8)
+#define MEM_BURST_LENGTH    (64)
+
+// a launch streams a batch of length prefixed packets from one contiguous
+// buffer, each packet is a header word holding [15:0] payload length in bytes
+// followed by the payload in ceil(length/8) words, first byte in [7:0], a zero
+// length header is padding and is skipped so batches can be padded to 512b
+static void memReadBurst(ap_uint<512>* mem,
+                         int size,
+                         hls::stream<ap_uint<512> >& beatStream) {
+
+	int beats = (size + MEM_WORDS_PER_BEAT - 1) / MEM_WORDS_PER_BEAT;
+	for (int i = 0; i < beats; i++) {
+#pragma HLS PIPELINE II=1
+		beatStream.write(mem[i]);
+	}
+}
+
+static void memReadFrame(int size,
+                         hls::stream<ap_uint<512> >& beatStream,
+                         hls::stream<ap_axiu<64,0,0,0> >& stream) {
+
     ap_axiu<64,0,0,0> v;
+    ap_uint<512> beat;
+    ap_uint<16> remaining = 0;
     // constant fields
     v.strb = 0xFF;
-    v.keep = 0xFF;
 	for (int i = 0; i < size; i++) {
-        ap_uint<64> a = mem[i];
-        v.data = a;
-		v.last = i==(size-1);
-        stream.write(v);
+#pragma HLS PIPELINE II=1
+		if ((i % MEM_WORDS_PER_BEAT) == 0) beat = beatStream.read();
+        ap_uint<64> a = beat.range((64*((i % MEM_WORDS_PER_BEAT)+1))-1, 64*(i % MEM_WORDS_PER_BEAT));
+		if (remaining == 0) {
+			remaining = a.range(15,0);
+		}
+		else {
+			v.data = a;
+			v.keep = (remaining >= 8) ? ap_uint<8>(0xFF) : ap_uint<8>((ap_uint<9>(1) << remaining) - 1);
+			v.last = (remaining <= 8);
+			remaining = (remaining <= 8) ? ap_uint<16>(0) : ap_uint<16>(remaining - 8);
+			stream.write(v);
+		}
     }
 }
+
+extern "C" {
+void memRead(ap_uint<512>* mem, int size, hls::stream<ap_axiu<64,0,0,0> >& stream) {
+	
+	#pragma HLS INTERFACE m_axi port=mem offset=slave max_read_burst_length=MEM_BURST_LENGTH
+	#pragma HLS INTERFACE axis register port=stream depth=32
+	#pragma HLS DATAFLOW
+	
+	static hls::stream<ap_uint<512> > beatStream;
+	#pragma HLS STREAM variable=beatStream depth=MEM_BURST_LENGTH
+
+	memReadBurst(mem, size, beatStream);
+	memReadFrame(size, beatStream, stream);
+}
 }
@@ -20,22 +20,193 @@
 typedef ap_axiu<64,0,0,0> ipTcpTxMetaPack_t;
 typedef ap_axiu<64,0,0,0> ipTcpTxDataPack_t;
 
+#define MW_RING_LEN        (65536)	// 512b slots, 4MB
+#define MW_WORDS_PER_SLOT  (8)
+
+// memWrite control
+#define MW_HALT            (1<<0)
+
+typedef struct memWriteRegControl_t
+{
+    ap_uint<32> control;
+    ap_uint<32> indexHead;
+    ap_uint<32> reserved02;
+    ap_uint<32> reserved03;
+    ap_uint<32> reserved04;
+    ap_uint<32> reserved05;
+    ap_uint<32> reserved06;
+    ap_uint<32> reserved07;
+} memWriteRegControl_t;
+
+typedef struct memWriteRegStatus_t
+{
+    ap_uint<32> status;
+    ap_uint<32> indexTail;
+    ap_uint<32> txMessage;
+    ap_uint<32> txFrame;
+    ap_uint<32> ringStall;
+    ap_uint<32> reserved05;
+    ap_uint<32> reserved06;
+    ap_uint<32> reserved07;
+} memWriteRegStatus_t;
+
+// orders gathered per call and written to the ring as a single burst, at
+// most 4KB so a burst never crosses an AXI 4KB boundary
+#define MW_BURST_LEN       (64)
+
+// egress is captured to a ring of 512b slots, each order is a header slot
+// followed by its payload packed 8 words per slot, [63:0] first:
+//   header [15:0] sessionID, [31:16] length, [47:32] subSum, [48] validSum
+//          [95:64] payload words, [127:96] message sequence,
+//          [191:128] kernel call count, a coarse timestamp
+// each call gathers the orders already queued, header and payload slots, in
+// a local buffer and writes them with one burst before advancing indexTail,
+// the host consumes from indexHead up to indexTail and then writes indexHead
+// back, indexes are free running and the ring stalls egress rather than
+// overwrite unread slots
 extern "C" {
-void memWrite(	ap_uint<64>* mem,
-				int & size,
-				hls::stream<ipTcpTxDataPack_t>& txDataStreamPack, 
-				hls::stream<ipTcpTxMetaPack_t>& txMetaStreamPack) {
-						
+void memWrite(memWriteRegControl_t &regControl,
+              memWriteRegStatus_t &regStatus,
+              ap_uint<512> *ring,
+              hls::stream<ipTcpTxDataPack_t>& txDataStreamPack,
+              hls::stream<ipTcpTxMetaPack_t>& txMetaStreamPack) {
+
+	#pragma HLS INTERFACE s_axilite port=regControl
+	#pragma HLS INTERFACE s_axilite port=regStatus
+	#pragma HLS INTERFACE ap_none port=regControl
+	#pragma HLS INTERFACE ap_none port=regStatus
+	#pragma HLS INTERFACE m_axi port=ring offset=slave max_write_burst_length=64
 	#pragma HLS INTERFACE axis register port=txDataStreamPack depth=64
 	#pragma HLS INTERFACE axis register port=txMetaStreamPack depth=64
-	
-	if(!txMetaStreamPack.empty()) ipTcpTxMetaPack_t dummy_metaData = txMetaStreamPack.read();
-    if(!txDataStreamPack.empty()){
-		for (int i = 0; i < size; i++) {
-			ap_axiu<64, 0, 0, 0> v = txDataStreamPack.read();
-			mem[i] = v.data;
-		}		
+	#pragma HLS INTERFACE s_axilite port=return
+	#pragma HLS DISAGGREGATE variable=regControl
+	#pragma HLS DISAGGREGATE variable=regStatus
+
+	// this ap_ctrl_hs kernel should run continuously when started, the host
+	// sets auto_restart as part of the kernel startup sequence
+
+	static ap_uint<32> countCall=0;
+	static ap_uint<32> countIndexTail=0;
+	static ipTcpTxMetaPack_t metaHeld;
+	static ap_uint<1> metaValid=0;
+	static ap_uint<1> ringStalled=0;
+	static ap_uint<32> countTxMessage=0;
+	static ap_uint<32> countTxFrame=0;
+	static ap_uint<32> countRingStall=0;
+
+	ipTcpTxDataPack_t txData;
+	ap_uint<512> burst[MW_BURST_LEN];
+	ap_uint<512> header;
+	ap_uint<32> burstCount=0;
+	ap_uint<32> orderSlots;
+	ap_uint<32> orderWords;
+	ap_uint<32> first;
+	ap_uint<32> span;
+	ap_uint<32> lengthWords;
+
+	++countCall;
+
+	if(0 == (MW_HALT & regControl.control))
+	{
+		// meta leads each payload, it is held across calls while the order
+		// waits for room in the burst or the ring
+loop_gather_order:
+		for(int order=0; order<(MW_BURST_LEN/2); order++)
+		{
+			if(!metaValid && !txMetaStreamPack.empty())
+			{
+				metaHeld = txMetaStreamPack.read();
+				metaValid = 1;
+			}
+
+			if(!metaValid)
+			{
+				break;
+			}
+
+			lengthWords = ((metaHeld.data.range(31,16) + 7) >> 3);
+			orderSlots = (1 + ((lengthWords + (MW_WORDS_PER_SLOT-1)) / MW_WORDS_PER_SLOT));
+
+			if((burstCount + orderSlots) > MW_BURST_LEN)
+			{
+				break;
+			}
+
+			// the header slot at indexTail is the first slot so one check
+			// covers the whole order, count each stall once as it begins
+			if(ap_uint<32>(countIndexTail + burstCount + orderSlots - regControl.indexHead) > MW_RING_LEN)
+			{
+				if(!ringStalled)
+				{
+					++countRingStall;
+				}
+				ringStalled = 1;
+				break;
+			}
+			ringStalled = 0;
+
+			// payload frames follow their meta back to back, pack them behind
+			// the header slot
+			orderWords = 0;
+loop_gather_word:
+			for(int word=0; word<((MW_BURST_LEN-1)*MW_WORDS_PER_SLOT); word++)
+			{
+#pragma HLS PIPELINE II=1
+				txData = txDataStreamPack.read();
+				if(0 == (word % MW_WORDS_PER_SLOT))
+				{
+					burst[burstCount + 1 + (word / MW_WORDS_PER_SLOT)] = 0;
+				}
+				burst[burstCount + 1 + (word / MW_WORDS_PER_SLOT)].range((64*(word % MW_WORDS_PER_SLOT))+63, 64*(word % MW_WORDS_PER_SLOT)) = txData.data;
+				++orderWords;
+				if(txData.last || (orderWords == lengthWords))
+				{
+					break;
+				}
+			}
+
+			header = 0;
+			header.range(48,0) = metaHeld.data.range(48,0);
+			header.range(95,64) = orderWords;
+			header.range(127,96) = countTxMessage;
+			header.range(191,128) = countCall;
+			burst[burstCount] = header;
+
+			burstCount += (1 + ((orderWords + (MW_WORDS_PER_SLOT-1)) / MW_WORDS_PER_SLOT));
+			countTxFrame += orderWords;
+			++countTxMessage;
+			metaValid = 0;
+		}
+
+		// write the gathered slots, split in two where they wrap the ring end
+		// so each span is a sequential burst
+		first = (countIndexTail % MW_RING_LEN);
+		span = ((burstCount < (MW_RING_LEN - first)) ? burstCount : ap_uint<32>(MW_RING_LEN - first));
+
+loop_burst_head:
+		for(int i=0; i<span; i++)
+		{
+#pragma HLS LOOP_TRIPCOUNT max=64
+#pragma HLS PIPELINE II=1
+			ring[first + i] = burst[i];
+		}
+
+loop_burst_wrap:
+		for(int i=span; i<burstCount; i++)
+		{
+#pragma HLS LOOP_TRIPCOUNT max=64
+#pragma HLS PIPELINE II=1
+			ring[i - span] = burst[i];
+		}
+
+		// publish once the burst is written
+		countIndexTail += burstCount;
 	}
 
+	regStatus.status = metaValid;
+	regStatus.indexTail = countIndexTail;
+	regStatus.txMessage = countTxMessage;
+	regStatus.txFrame = countTxFrame;
+	regStatus.ringStall = countRingStall;
 }
 }
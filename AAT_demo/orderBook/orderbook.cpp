@@ -63,7 +63,6 @@ void OrderBook::operationProcess(ap_uint<32> &regProcessOperation,
 {
 #pragma HLS PIPELINE II=1 style=flp
 
-    mmInterface intf;
     orderBookOperation_t operation;
     orderBookResponse_t response;
     ap_uint<64> timestamp;
@@ -683,19 +682,22 @@ void OrderBook::responseDump(ap_uint<1024> responseDump[1],
 
 void OrderBook::responseMove(ap_uint<32> &regControl,
                              ap_uint<32> &regIndexHead,
-                             ap_uint<32> &regIndexTail,
                              ap_uint<32> &regTxResponse,
                              ap_uint<32> &regCyclesPre,
-                             ap_uint<1024> ringBuffer[OB_DM_RING_BUF_LEN],
-                             hls::stream<orderBookResponsePack_t> &responseStreamPack)
+                             ap_uint<32> &regTxOverflow,
+                             hls::stream<orderBookResponsePack_t> &responseStreamPack,
+                             hls::stream<orderBookDataMoverEntry_t> &entryStream)
 {
 #pragma HLS PIPELINE II=1 style=flp
 
     orderBookResponsePack_t responsePack;
+    orderBookDataMoverEntry_t entry;
+    ap_uint<32> txUsed;
 
     static ap_uint<32> countCycles=0;
-    static ap_uint<16> countIndexTail=0;
     static ap_uint<32> countTxResponse=0;
+    static ap_uint<32> countTxOverflow=0;
+    static ap_uint<1> txStalled=0;
 
     // TODO: move local counter to class?
     if(OB_DM_RTT_RESET & regControl)
@@ -710,24 +712,161 @@ void OrderBook::responseMove(ap_uint<32> &regControl,
         }
     }
 
-    if(!responseStreamPack.empty())
+    // a full ring either holds responses in the stream, backpressuring
+    // OrderBook, or overwrites the oldest unread entry, software detects the
+    // latter when indexTxTail has moved more than a ring length past its head,
+    // responses admitted here but still waiting on their burst count as used,
+    // txOverflow counts responses that found the ring full, each overwrite
+    // and each response held is counted once however long it is held
+    txUsed = countTxResponse - regIndexHead;
+
+    if(!responseStreamPack.empty() && !entryStream.full())
     {
-        responsePack = responseStreamPack.read();
+        if((txUsed < OB_DM_RING_BUF_LEN) || (OB_DM_DROP_OLDEST & regControl))
+        {
+            responsePack = responseStreamPack.read();
 
-        // inject local timestamp for host rtt latency measurement
-        if(OB_DM_RTT_ENABLE & regControl)
+            // inject local timestamp for host rtt latency measurement
+            if(OB_DM_RTT_ENABLE & regControl)
+            {
+                responsePack.data.range(1023,968) = countCycles;
+            }
+
+            if(txUsed >= OB_DM_RING_BUF_LEN)
+            {
+                ++countTxOverflow;
+            }
+
+            // admit to the ring, the slot is the next free running index
+            txStalled = 0;
+            ++countTxResponse;
+            entry.data = responsePack.data;
+            entry.txResponse = countTxResponse;
+            entry.txOverflow = countTxOverflow;
+            entry.cycles = countCycles;
+            entryStream.write(entry);
+        }
+        else
         {
-            responsePack.data.range(1023,968) = countCycles;
+            // response held against a full ring, counted as the stall begins
+            if(!txStalled)
+            {
+                ++countTxOverflow;
+            }
+            txStalled = 1;
         }
-
-        // write to ring buffer, advance tail pointer
-        ringBuffer[countIndexTail++] = responsePack.data;
-        ++countTxResponse;
     }
 
     regCyclesPre = countCycles;
-    regIndexTail = countIndexTail;
     regTxResponse = countTxResponse;
+    regTxOverflow = countTxOverflow;
+
+    return;
+}
+
+void OrderBook::responseBurst(ap_uint<32> &regWriteBackCount,
+                              ap_uint<32> &regWriteBackCycles,
+                              ap_uint<32> &regIndexTail,
+                              ap_uint<32> &regTxWriteBack,
+                              ap_uint<512> ringBuffer[OB_DM_RING_BUF_LEN*OB_DM_BEATS_PER_ENTRY],
+                              ap_uint<512> *writeBack,
+                              hls::stream<orderBookDataMoverEntry_t> &entryStream)
+{
+    orderBookDataMoverEntry_t entry;
+    ap_uint<512> writeBackData=0;
+    ap_uint<32> beatBase;
+    ap_uint<1> burstFlush=0;
+
+    static ap_uint<1024> burst[OB_DM_BURST_LEN];
+    static ap_uint<8> burstCount=0;
+    static ap_uint<32> burstTxResponse=0;
+    static ap_uint<32> burstTxOverflow=0;
+    static ap_uint<32> burstCycles=0;
+
+    static ap_uint<32> countIndexTail=0;
+    static ap_uint<32> countWriteBackEntry=0;
+    static ap_uint<32> countWriteBackCycles=0;
+    static ap_uint<32> countTxWriteBack=0;
+
+    // responses arriving back to back are gathered and written as one burst
+    // of 512b beats, the burst is written once the stream runs dry or the
+    // next response would start a new OB_DM_BURST_LEN aligned block of
+    // entries, so a full burst starts on a burst boundary and a burst never
+    // wraps the ring, a lone response is written as soon as it arrives
+    if(!entryStream.empty())
+    {
+        entry = entryStream.read();
+        burst[burstCount] = entry.data;
+        ++burstCount;
+        burstTxResponse = entry.txResponse;
+        burstTxOverflow = entry.txOverflow;
+        burstCycles = entry.cycles;
+        burstFlush = (0 == ((countIndexTail + burstCount) & (OB_DM_BURST_LEN-1)));
+    }
+    else
+    {
+        burstFlush = (0 != burstCount);
+    }
+
+    if(burstFlush)
+    {
+        beatBase = (countIndexTail.range(OB_DM_RING_INDEX_BITS-1,0) * OB_DM_BEATS_PER_ENTRY);
+
+loop_burst_beat:
+        for(int i=0; i<(burstCount * OB_DM_BEATS_PER_ENTRY); i++)
+        {
+#pragma HLS LOOP_TRIPCOUNT max=16
+#pragma HLS PIPELINE II=1
+            // least significant half of each entry first, as the host reads
+            // a 1024b entry from consecutive addresses
+            if(i & 1)
+            {
+                ringBuffer[beatBase + i] = burst[i >> 1].range(1023,512);
+            }
+            else
+            {
+                ringBuffer[beatBase + i] = burst[i >> 1].range(511,0);
+            }
+        }
+
+        // tail only advances once the burst is written, entries written
+        // while write back is disabled are not notified
+        countIndexTail += burstCount;
+        if((0 != regWriteBackCount) || (0 != regWriteBackCycles))
+        {
+            countWriteBackEntry += burstCount;
+        }
+        burstCount = 0;
+    }
+
+    // batched tail notification, rather than software polling indexTxTail
+    // over AXI-Lite a single 512b descriptor is written to memory once every
+    // writeBackCount entries, or writeBackCycles after the first entry not yet
+    // notified, a zero in either register disables that trigger, counters
+    // are as of the last entry written:
+    //   [31:0] indexTxTail, [63:32] txResponse, [95:64] txOverflow,
+    //   [127:96] descriptor sequence, [159:128] cycles
+    if(0 != countWriteBackEntry)
+    {
+        ++countWriteBackCycles;
+    }
+
+    if(((0 != regWriteBackCount) && (countWriteBackEntry >= regWriteBackCount)) ||
+       ((0 != regWriteBackCycles) && (countWriteBackCycles >= regWriteBackCycles)))
+    {
+        ++countTxWriteBack;
+        writeBackData.range(31,0) = countIndexTail;
+        writeBackData.range(63,32) = burstTxResponse;
+        writeBackData.range(95,64) = burstTxOverflow;
+        writeBackData.range(127,96) = countTxWriteBack;
+        writeBackData.range(159,128) = burstCycles;
+        writeBack[0] = writeBackData;
+        countWriteBackEntry = 0;
+        countWriteBackCycles = 0;
+    }
+
+    regIndexTail = countIndexTail;
+    regTxWriteBack = countTxWriteBack;
 
     return;
 }
@@ -744,6 +883,7 @@ void OrderBook::operationMove(ap_uint<32> &regControl,
                               ap_uint<32> &regCyclesPost,
                               ap_uint<32> &regRxThrottleCount,
                               ap_uint<32> &regRxThrottleEvent,
+                              ap_uint<32> &regRxOverflow,
                               ap_uint<256> ringBuffer[OB_DM_RING_BUF_LEN],
                               hls::stream<orderEntryOperationPack_t> &operationStreamPack)
 {
@@ -753,10 +893,12 @@ void OrderBook::operationMove(ap_uint<32> &regControl,
     orderEntryOperationPack_t operationPack;
     orderEntryOperation_t operation;
     ap_uint<32> latencyDiff;
+    ap_uint<32> rxUsed;
 
     static ap_uint<32> countCycles=0;
-    static ap_uint<16> countIndexHead=0;
+    static ap_uint<32> countIndexHead=0;
     static ap_uint<32> countRxOperation=0;
+    static ap_uint<32> countRxOverflow=0;
     static ap_uint<32> countRxThrottle=0;
     static ap_uint<32> countRxBackpressure=0;
 
@@ -783,18 +925,26 @@ void OrderBook::operationMove(ap_uint<32> &regControl,
     }
 
     // use rate throttle to account for software stalls where data can back up
-    // in H2C ring buffer, OrderEntry operations expand to minumum of 32 frames
-    // in OrderEntry send, without a throttle this expansion can saturate that
-    // kernel and result in deadlock, alternative approach would be to buffer
-    // operations downstream before the send but data is already buffered here,
-    // simple addition of dispatch rate seems like the logical approach
+    // in H2C ring buffer, OrderEntry now holds operations against TCP transmit
+    // credit and backpressures this stream rather than dropping, so a rate of
+    // zero is safe, the throttle remains to pace bursts out of the ring buffer
+    rxUsed = regIndexTail - countIndexHead;
+
     if(0 == countRxThrottle)
     {
-        // TODO: buffer wrap checks needed?
-        if(countIndexHead != regIndexTail)
+        if(rxUsed > OB_DM_RING_BUF_LEN)
+        {
+            // software has written more than a ring length past indexRxHead,
+            // the oldest unread entries are gone, resume at the oldest intact
+            countRxOverflow += (rxUsed - OB_DM_RING_BUF_LEN);
+            countIndexHead = regIndexTail - OB_DM_RING_BUF_LEN;
+        }
+        else if((0 != rxUsed) && !operationStreamPack.full())
         {
-            // read from ring buffer, advance head pointer
-            operationPack.data = ringBuffer[countIndexHead++];
+            // read from ring buffer, advance head pointer, held in the ring
+            // while OrderEntry backpressures
+            operationPack.data = ringBuffer[countIndexHead.range(OB_DM_RING_INDEX_BITS-1,0)];
+            ++countIndexHead;
             ++countRxOperation;
 
             // debug control to disable forwarding operations
@@ -845,7 +995,7 @@ void OrderBook::operationMove(ap_uint<32> &regControl,
     else
     {
         --countRxThrottle;
-        if((countIndexHead != regIndexTail) && (0 == countRxThrottle))
+        if((0 != rxUsed) && (0 == countRxThrottle))
         {
             // update received from host while under throttle
             ++countRxBackpressure;
@@ -861,6 +1011,7 @@ void OrderBook::operationMove(ap_uint<32> &regControl,
     regCyclesPost = countCycles;
     regRxThrottleCount = countRxThrottle;
     regRxThrottleEvent = countRxBackpressure;
+    regRxOverflow = countRxOverflow;
 
     return;
 }
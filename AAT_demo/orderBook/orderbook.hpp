@@ -22,7 +22,17 @@
 #include "aat_defines.hpp"
 #include "aat_interfaces.hpp"
 
-#define OB_DM_RING_BUF_LEN (65536)
+// ring indexes are free running 32b counts, the slot is the count modulo the
+// ring length, override the index width at build time to resize the rings
+#ifndef OB_DM_RING_INDEX_BITS
+#define OB_DM_RING_INDEX_BITS (16)
+#endif
+#define OB_DM_RING_BUF_LEN (1<<OB_DM_RING_INDEX_BITS)
+
+// responses are written to the ring as 512b beats, two per entry, gathered
+// into bursts of up to OB_DM_BURST_LEN entries, power of two
+#define OB_DM_BURST_LEN       (8)
+#define OB_DM_BEATS_PER_ENTRY (2)
 
 // OrderBook control
 #define OB_DM_FWD_ENABLE  (1<<3)
@@ -32,6 +42,7 @@
 #define OB_CAPTURE_FREEZE (1<<31)
 
 // OrderBookDataMover control
+#define OB_DM_DROP_OLDEST (1<<3)
 #define OB_DM_RTT_RESET  (1<<2)
 #define OB_DM_RTT_ENABLE (1<<1)
 #define OB_DM_HALT       (1<<0)
@@ -82,8 +93,8 @@ typedef struct orderBookDataMoverRegControl_t
     ap_uint<32> indexTxHead;
     ap_uint<32> indexRxTail;
     ap_uint<32> rxThrottleRate;
-    ap_uint<32> reserved04;
-    ap_uint<32> reserved05;
+    ap_uint<32> writeBackCount;
+    ap_uint<32> writeBackCycles;
     ap_uint<32> reserved06;
     ap_uint<32> reserved07;
 } orderBookDataMoverRegControl_t;
@@ -103,11 +114,21 @@ typedef struct orderBookDataMoverRegStatus_t
     ap_uint<32> cyclesPost;
     ap_uint<32> rxThrottleCount;
     ap_uint<32> rxThrottleEvent;
-    ap_uint<32> reserved13;
-    ap_uint<32> reserved14;
-    ap_uint<32> reserved15;
+    ap_uint<32> txOverflow;
+    ap_uint<32> rxOverflow;
+    ap_uint<32> txWriteBack;
 } orderBookDataMoverRegStatus_t;
 
+// response admitted to the ring, with the counters reported in the tail
+// write back as they were when the response was admitted
+typedef struct orderBookDataMoverEntry_t
+{
+    ap_uint<1024> data;
+    ap_uint<32>   txResponse;
+    ap_uint<32>   txOverflow;
+    ap_uint<32>   cycles;
+} orderBookDataMoverEntry_t;
+
 /**
  * OrderBook Core
  */
@@ -190,11 +211,19 @@ public:
 
     void responseMove(ap_uint<32> &regControl,
                       ap_uint<32> &regIndexHead,
-                      ap_uint<32> &regIndexTail,
                       ap_uint<32> &regTxResponse,
                       ap_uint<32> &regCyclesPre,
-                      ap_uint<1024> ringBuffer[OB_DM_RING_BUF_LEN],
-                      hls::stream<orderBookResponsePack_t> &responseStreamPack);
+                      ap_uint<32> &regTxOverflow,
+                      hls::stream<orderBookResponsePack_t> &responseStreamPack,
+                      hls::stream<orderBookDataMoverEntry_t> &entryStream);
+
+    void responseBurst(ap_uint<32> &regWriteBackCount,
+                       ap_uint<32> &regWriteBackCycles,
+                       ap_uint<32> &regIndexTail,
+                       ap_uint<32> &regTxWriteBack,
+                       ap_uint<512> ringBuffer[OB_DM_RING_BUF_LEN*OB_DM_BEATS_PER_ENTRY],
+                       ap_uint<512> *writeBack,
+                       hls::stream<orderBookDataMoverEntry_t> &entryStream);
 
     void operationMove(ap_uint<32> &regControl,
                        ap_uint<32> &regIndexTail,
@@ -208,6 +237,7 @@ public:
                        ap_uint<32> &regCyclesPost,
                        ap_uint<32> &rxThrottleCount,
                        ap_uint<32> &rxThrottleEvent,
+                       ap_uint<32> &regRxOverflow,
                        ap_uint<256> ringBuffer[OB_DM_RING_BUF_LEN],
                        hls::stream<orderEntryOperationPack_t> &operationStreamPack);
 
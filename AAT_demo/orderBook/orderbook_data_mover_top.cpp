@@ -19,13 +19,15 @@
 
 extern "C" void orderBookDataMoverTop(orderBookDataMoverRegControl_t &regControl,
                                       orderBookDataMoverRegStatus_t &regStatus,
-                                      ap_uint<1024> *ringBufferTx,
+                                      ap_uint<512> *ringBufferTx,
                                       ap_uint<256> *ringBufferRx,
+                                      ap_uint<512> *writeBack,
                                       hls::stream<orderBookResponsePack_t> &responseStreamPack,
                                       hls::stream<orderEntryOperationPack_t> &operationStreamPack)
 {
-#pragma HLS INTERFACE m_axi port=ringBufferTx offset=slave
+#pragma HLS INTERFACE m_axi port=ringBufferTx offset=slave max_write_burst_length=16 num_write_outstanding=32
 #pragma HLS INTERFACE m_axi port=ringBufferRx offset=slave
+#pragma HLS INTERFACE m_axi port=writeBack offset=slave bundle=gmem1
 #pragma HLS INTERFACE s_axilite port=regControl
 #pragma HLS INTERFACE s_axilite port=regStatus
 #pragma HLS INTERFACE ap_none port=regControl
@@ -34,10 +36,14 @@ extern "C" void orderBookDataMoverTop(orderBookDataMoverRegControl_t &regControl
 #pragma HLS INTERFACE axis port=operationStreamPack
 #pragma HLS INTERFACE s_axilite port=return
 
+    static hls::stream<orderBookDataMoverEntry_t> txEntryFIFO;
     static OrderBook kernel;
 
+// admitted responses queue while a burst is written, up to two bursts
+#pragma HLS STREAM variable=txEntryFIFO depth=16
 #pragma HLS DISAGGREGATE variable=regControl
 #pragma HLS DISAGGREGATE variable=regStatus
+#pragma HLS DATAFLOW disable_start_propagation
 
     // this ap_ctrl_hs kernel should run continuously when started, to avoid
     // an inner loop we can use auto_restart functionality, this is a control
@@ -45,11 +51,19 @@ extern "C" void orderBookDataMoverTop(orderBookDataMoverRegControl_t &regControl
 
     kernel.responseMove(regControl.control,
                         regControl.indexTxHead,
-                        regStatus.indexTxTail,
                         regStatus.txResponse,
                         regStatus.cyclesPre,
-                        ringBufferTx,
-                        responseStreamPack);
+                        regStatus.txOverflow,
+                        responseStreamPack,
+                        txEntryFIFO);
+
+    kernel.responseBurst(regControl.writeBackCount,
+                         regControl.writeBackCycles,
+                         regStatus.indexTxTail,
+                         regStatus.txWriteBack,
+                         ringBufferTx,
+                         writeBack,
+                         txEntryFIFO);
 
     kernel.operationMove(regControl.control,
                          regControl.indexRxTail,
@@ -63,6 +77,7 @@ extern "C" void orderBookDataMoverTop(orderBookDataMoverRegControl_t &regControl
                          regStatus.cyclesPost,
                          regStatus.rxThrottleCount,
                          regStatus.rxThrottleEvent,
+                         regStatus.rxOverflow,
                          ringBufferRx,
                          operationStreamPack);
 
@@ -28,8 +28,9 @@ extern "C" void orderBookTop(orderBookRegControl_t &regControl,
 
 extern "C" void orderBookDataMoverTop(orderBookDataMoverRegControl_t &regControl,
                                       orderBookDataMoverRegStatus_t &regStatus,
-                                      ap_uint<1024> *ringBufferTx,
+                                      ap_uint<512> *ringBufferTx,
                                       ap_uint<256> *ringBufferRx,
+                                      ap_uint<512> *writeBack,
                                       hls::stream<orderBookResponsePack_t> &responseStreamPack,
                                       hls::stream<orderEntryOperationPack_t> &operationStreamPack);
 
@@ -28,6 +28,7 @@ open_project -reset $PROJ
 add_files "${CASE_ROOT}/../../common/includes/aat_interfaces.cpp" -cflags ${CFLAGS}
 add_files "${KERNEL_ROOT}/orderbook.cpp" -cflags ${CFLAGS}
 add_files "${KERNEL_ROOT}/orderbook_top.cpp" -cflags ${CFLAGS}
+add_files "${KERNEL_ROOT}/orderbook_data_mover_top.cpp" -cflags ${CFLAGS}
 add_files -tb "tb_orderbook.cpp" -cflags "-I${KERNEL_ROOT} ${CFLAGS}"
 
 set_top orderBookTop
@@ -213,6 +213,181 @@ int main()
     std::cout << "OB_RX_EVENT=" << regStatus.rxEvent << " ";
     std::cout << std::endl;
 
+    // data mover rings, fill the response ring against a stalled host then
+    // overrun the operation ring from the host side, responses are written
+    // as two 512b beats per entry with the index in each half
+    static ap_uint<512> ringBufferTx[OB_DM_RING_BUF_LEN*OB_DM_BEATS_PER_ENTRY];
+    static ap_uint<256> ringBufferRx[OB_DM_RING_BUF_LEN];
+    static ap_uint<512> writeBack[1];
+    orderBookDataMoverRegControl_t regDataMoverControl={0};
+    orderBookDataMoverRegStatus_t regDataMoverStatus={0};
+    hls::stream<orderBookResponsePack_t> moverResponseStreamPackFIFO;
+    hls::stream<orderEntryOperationPack_t> moverOperationStreamPackFIFO;
+    orderEntryOperationPack_t moverOperationPack;
+    int ringErrors=0;
+
+    // aggregate initialisation only zeroes the first register
+    regDataMoverControl.indexTxHead = 0;
+    regDataMoverControl.indexRxTail = 0;
+    regDataMoverControl.rxThrottleRate = 0;
+    regDataMoverControl.writeBackCount = 0;
+    regDataMoverControl.writeBackCycles = 0;
+
+    for(int i=0; i<(OB_DM_RING_BUF_LEN+4); i++)
+    {
+        responsePack.data = 0;
+        responsePack.data.range(31,0) = i;
+        responsePack.data.range(543,512) = i;
+        moverResponseStreamPackFIFO.write(responsePack);
+    }
+
+    for(int i=0; i<(OB_DM_RING_BUF_LEN+8); i++)
+    {
+        orderBookDataMoverTop(regDataMoverControl,
+                              regDataMoverStatus,
+                              ringBufferTx,
+                              ringBufferRx,
+                              writeBack,
+                              moverResponseStreamPackFIFO,
+                              moverOperationStreamPackFIFO);
+    }
+
+    // full ring holds the last 4 responses in the stream, the held response
+    // is counted once for the whole stall
+    if((OB_DM_RING_BUF_LEN != regDataMoverStatus.indexTxTail) ||
+       (4 != moverResponseStreamPackFIFO.size()) ||
+       (1 != regDataMoverStatus.txOverflow))
+    {
+        ++ringErrors;
+    }
+
+    // releasing two slots admits two responses into the oldest slots
+    regDataMoverControl.indexTxHead = 2;
+    for(int i=0; i<4; i++)
+    {
+        orderBookDataMoverTop(regDataMoverControl,
+                              regDataMoverStatus,
+                              ringBufferTx,
+                              ringBufferRx,
+                              writeBack,
+                              moverResponseStreamPackFIFO,
+                              moverOperationStreamPackFIFO);
+    }
+    if(((OB_DM_RING_BUF_LEN+2) != regDataMoverStatus.indexTxTail) ||
+       (OB_DM_RING_BUF_LEN != ringBufferTx[0].range(31,0)) ||
+       (OB_DM_RING_BUF_LEN != ringBufferTx[1].range(31,0)) ||
+       ((OB_DM_RING_BUF_LEN+1) != ringBufferTx[2].range(31,0)) ||
+       ((OB_DM_RING_BUF_LEN+1) != ringBufferTx[3].range(31,0)))
+    {
+        ++ringErrors;
+    }
+
+    // drop oldest overwrites unread entries and counts each one
+    ap_uint<32> txOverflowHeld = regDataMoverStatus.txOverflow;
+    regDataMoverControl.control = OB_DM_DROP_OLDEST;
+    for(int i=0; i<4; i++)
+    {
+        orderBookDataMoverTop(regDataMoverControl,
+                              regDataMoverStatus,
+                              ringBufferTx,
+                              ringBufferRx,
+                              writeBack,
+                              moverResponseStreamPackFIFO,
+                              moverOperationStreamPackFIFO);
+    }
+    if(((OB_DM_RING_BUF_LEN+4) != regDataMoverStatus.indexTxTail) ||
+       ((txOverflowHeld+2) != regDataMoverStatus.txOverflow) ||
+       ((OB_DM_RING_BUF_LEN+3) != ringBufferTx[6].range(31,0)) ||
+       ((OB_DM_RING_BUF_LEN+3) != ringBufferTx[7].range(31,0)))
+    {
+        ++ringErrors;
+    }
+
+    // host tail a ring length plus 5 ahead, the 5 oldest entries are lost
+    for(int i=0; i<OB_DM_RING_BUF_LEN; i++)
+    {
+        ringBufferRx[i] = i;
+    }
+    regDataMoverControl.control = 0;
+    regDataMoverControl.indexRxTail = OB_DM_RING_BUF_LEN+5;
+    for(int i=0; i<(OB_DM_RING_BUF_LEN+2); i++)
+    {
+        orderBookDataMoverTop(regDataMoverControl,
+                              regDataMoverStatus,
+                              ringBufferTx,
+                              ringBufferRx,
+                              writeBack,
+                              moverResponseStreamPackFIFO,
+                              moverOperationStreamPackFIFO);
+    }
+    if(((OB_DM_RING_BUF_LEN+5) != regDataMoverStatus.indexRxHead) ||
+       (5 != regDataMoverStatus.rxOverflow) ||
+       (OB_DM_RING_BUF_LEN != moverOperationStreamPackFIFO.size()))
+    {
+        ++ringErrors;
+    }
+    else
+    {
+        moverOperationPack = moverOperationStreamPackFIFO.read();
+        if(5 != moverOperationPack.data.range(31,0))
+        {
+            ++ringErrors;
+        }
+    }
+
+    // tail write back every 2 entries, then on the cycle timer for the last,
+    // the first 4 arrive back to back up to a burst boundary so land in a
+    // single burst covered by a single write back
+    regDataMoverControl.indexTxHead = regDataMoverStatus.indexTxTail;
+    regDataMoverControl.writeBackCount = 2;
+    regDataMoverControl.writeBackCycles = 8;
+    for(int i=0; i<5; i++)
+    {
+        responsePack.data = i;
+        moverResponseStreamPackFIFO.write(responsePack);
+    }
+    for(int i=0; i<4; i++)
+    {
+        orderBookDataMoverTop(regDataMoverControl,
+                              regDataMoverStatus,
+                              ringBufferTx,
+                              ringBufferRx,
+                              writeBack,
+                              moverResponseStreamPackFIFO,
+                              moverOperationStreamPackFIFO);
+    }
+    if((1 != regDataMoverStatus.txWriteBack) ||
+       ((regDataMoverControl.indexTxHead+4) != writeBack[0].range(31,0)))
+    {
+        ++ringErrors;
+    }
+    for(int i=0; i<9; i++)
+    {
+        orderBookDataMoverTop(regDataMoverControl,
+                              regDataMoverStatus,
+                              ringBufferTx,
+                              ringBufferRx,
+                              writeBack,
+                              moverResponseStreamPackFIFO,
+                              moverOperationStreamPackFIFO);
+    }
+    if((2 != regDataMoverStatus.txWriteBack) ||
+       (regDataMoverStatus.indexTxTail != writeBack[0].range(31,0)) ||
+       (regDataMoverStatus.txResponse != writeBack[0].range(63,32)) ||
+       (regDataMoverStatus.txOverflow != writeBack[0].range(95,64)) ||
+       (2 != writeBack[0].range(127,96)))
+    {
+        ++ringErrors;
+    }
+
+    std::cout << "DATAMOVER: TX_TAIL=" << regDataMoverStatus.indexTxTail << " ";
+    std::cout << "TX_OVERFLOW=" << regDataMoverStatus.txOverflow << " ";
+    std::cout << "RX_HEAD=" << regDataMoverStatus.indexRxHead << " ";
+    std::cout << "RX_OVERFLOW=" << regDataMoverStatus.rxOverflow << " ";
+    std::cout << "TX_WRITE_BACK=" << regDataMoverStatus.txWriteBack << " ";
+    std::cout << std::endl;
+    std::cout << std::dec << "RING: checked 5 cases, " << ringErrors << " mismatches" << std::endl;
+
     std::cout << std::endl;
     std::cout << "Done!" << std::endl;
 
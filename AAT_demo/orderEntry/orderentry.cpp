@@ -21,34 +21,138 @@
  * OrderEntry Core
  */
 
-void OrderEntry::operationPull(ap_uint<32> &regRxOperation,
+// namespace scope definitions for templates indexed at run time (C++14)
+constexpr unsigned short OrderEntry::messageTemplateLength[OE_MSG_NUM_TEMPLATE];
+constexpr unsigned char OrderEntry::messageTemplate[OE_MSG_NUM_TEMPLATE][OE_MSG_MAX_BYTES];
+constexpr unsigned short OrderEntry::messageTemplateSum[OE_MSG_NUM_TEMPLATE];
+constexpr unsigned short OrderEntry::messageBodyLength[OE_MSG_NUM_TEMPLATE];
+constexpr unsigned char OrderEntry::messageTemplateByteSum[OE_MSG_NUM_TEMPLATE];
+
+void OrderEntry::sendingTimeClock(ap_uint<32> &regSendingDate,
+                                  ap_uint<32> &regSendingTime)
+{
+#pragma HLS PIPELINE II=1 style=flp
+
+    ap_uint<1> timeLoad;
+
+    static ap_uint<36> time=0;
+    static ap_uint<20> countCycle=0;
+    static ap_uint<1> timeLoadPrev=0;
+
+    // free running time of day clock in UTC, host loads HHMMSS as BCD on a
+    // rising edge of the load bit and milliseconds restart from zero, the
+    // date is used as programmed and must be updated by the host at midnight
+    timeLoad = ((OE_TIME_LOAD & regSendingTime) ? 1 : 0);
+
+    if(timeLoad && !timeLoadPrev)
+    {
+        time = (regSendingTime.range(23,0), ap_uint<12>(0));
+        countCycle = 0;
+    }
+    else if((OE_CLOCK_CYCLES_PER_MS-1) == countCycle)
+    {
+        time = sendingTimeIncrement(time);
+        countCycle = 0;
+    }
+    else
+    {
+        ++countCycle;
+    }
+
+    timeLoadPrev = timeLoad;
+
+    // single point of update for private struct
+    mSendingTime.date = regSendingDate;
+    mSendingTime.time = time;
+}
+
+void OrderEntry::operationPull(ap_uint<32> &regProtocol,
+                               ap_uint<32> &regRxOperation,
+                               ap_uint<32> regSessionRoute[NUM_SYMBOL],
                                hls::stream<orderEntryOperationPack_t> &operationStreamPack,
                                hls::stream<orderEntryOperationPack_t> &operationHostStreamPack,
-                               hls::stream<orderEntryOperation_t> &operationStream)
+                               hls::stream<orderEntryOperationEncode_t> &operationStream,
+                               hls::stream<orderEntryOperationEncode_t> &operationCancelStream,
+                               hls::stream<orderEntryOperationEncode_t> &operationTxStream,
+                               hls::stream<orderEntryOperationEncode_t> &operationTxCancelStream)
 {
 #pragma HLS PIPELINE II=1 style=flp
 
     mmInterface intf;
     orderEntryOperationPack_t operationPack;
     orderEntryOperation_t operation;
+    orderEntryOperationEncode_t operationEncode;
+    ap_uint<8> session;
+    ap_uint<1> validOperation=0, queueReady, binary;
 
     static ap_uint<32> countRxOperation=0;
 
+    // operations are only accepted while every queue has room, the class of
+    // an operation is not known until it is read and a blocked write here
+    // would stall cancels behind it, a full queue instead backpressures the
+    // input streams toward PricingEngine and the host
+    queueReady = (!operationStream.full() &&
+                  !operationCancelStream.full() &&
+                  !operationTxStream.full() &&
+                  !operationTxCancelStream.full());
+
     // priority to direct path from PricingEngine then host offload path
     // TODO: add register control to enable/disable these different paths?
-    if(!operationStreamPack.empty())
+    if(queueReady && !operationStreamPack.empty())
     {
         operationPack = operationStreamPack.read();
         ++countRxOperation;
-        intf.orderEntryOperationUnpack(&operationPack, &operation);
-        operationStream.write(operation);
+        validOperation = 1;
     }
-    else if(!operationHostStreamPack.empty())
+    else if(queueReady && !operationHostStreamPack.empty())
     {
         operationPack = operationHostStreamPack.read();
         ++countRxOperation;
+        validOperation = 1;
+    }
+
+    if(validOperation)
+    {
         intf.orderEntryOperationUnpack(&operationPack, &operation);
-        operationStream.write(operation);
+
+        // orders are routed to a session by symbol, fields are carried
+        // unconverted in the low bits of the encoded operation until the
+        // ASCII encode stage so both protocols share the message builder,
+        // protocol is selected per session
+        session = (regSessionRoute[operation.symbolIndex] & (OE_NUM_SESSION-1));
+        binary = ((regProtocol >> session) & OE_PROTOCOL_BINARY);
+
+        operationEncode.timestamp = operation.timestamp;
+        operationEncode.opCode = operation.opCode;
+        operationEncode.symbolIndex = operation.symbolIndex;
+        operationEncode.orderId = operation.orderId;
+        operationEncode.origOrderId = operation.origOrderId;
+        operationEncode.quantity = operation.quantity;
+        operationEncode.price = operation.price;
+        operationEncode.direction = operation.direction;
+        operationEncode.session = session;
+        operationEncode.binary = binary;
+
+        // every operation goes straight to the transmit stage so the message
+        // prefix can be sent while FIX fields are still in the ASCII encode
+        // stage, binary messages need no encode, cancels are queued apart
+        // from new orders and modifies so they can be sent ahead of them
+        if(ORDERENTRY_DELETE == operation.opCode)
+        {
+            operationTxCancelStream.write(operationEncode);
+            if(!binary)
+            {
+                operationCancelStream.write(operationEncode);
+            }
+        }
+        else
+        {
+            operationTxStream.write(operationEncode);
+            if(!binary)
+            {
+                operationStream.write(operationEncode);
+            }
+        }
     }
 
     regRxOperation = countRxOperation;
@@ -56,32 +160,53 @@ void OrderEntry::operationPull(ap_uint<32> &regRxOperation,
     return;
 }
 
-void OrderEntry::operationEncode(hls::stream<orderEntryOperation_t> &operationStream,
-                                 hls::stream<orderEntryOperationEncode_t> &operationEncodeStream)
+void OrderEntry::operationEncode(hls::stream<orderEntryOperationEncode_t> &operationStream,
+                                 hls::stream<orderEntryOperationEncode_t> &operationCancelStream,
+                                 hls::stream<orderEntryOperationEncode_t> &operationEncodeStream,
+                                 hls::stream<orderEntryOperationEncode_t> &operationEncodeCancelStream)
 {
 #pragma HLS PIPELINE II=1 style=flp
 
-    orderEntryOperation_t operation;
     orderEntryOperationEncode_t operationEncode;
-    ap_uint<80> orderIdEncode, quantityEncode, priceEncode;
+    ap_uint<80> orderIdEncode, origOrderIdEncode, quantityEncode;
+    ap_uint<88> priceEncode;
+    ap_uint<1> validOperation=0, cancelOperation=0;
 
-    if(!operationStream.empty())
+    // cancels first, each class only advances while its output has room so
+    // a backlog of new orders does not hold up the cancel queue
+    if(!operationCancelStream.empty() && !operationEncodeCancelStream.full())
+    {
+        operationEncode = operationCancelStream.read();
+        validOperation = 1;
+        cancelOperation = 1;
+    }
+    else if(!operationStream.empty() && !operationEncodeStream.full())
     {
-        operation = operationStream.read();
+        operationEncode = operationStream.read();
+        validOperation = 1;
+    }
 
-        orderIdEncode = uint32ToAscii(operation.orderId);
-        quantityEncode = uint32ToAscii(operation.quantity);
-        priceEncode = uint32ToAscii(operation.price);
+    if(validOperation)
+    {
+
+        orderIdEncode = uint32ToAscii(operationEncode.orderId.range(31,0));
+        origOrderIdEncode = uint32ToAscii(operationEncode.origOrderId.range(31,0));
+        quantityEncode = uint32ToAscii(operationEncode.quantity.range(31,0));
+        priceEncode = priceToAscii(operationEncode.price.range(31,0));
 
-        operationEncode.timestamp = operation.timestamp;
-        operationEncode.opCode = operation.opCode;
-        operationEncode.symbolIndex = operation.symbolIndex;
         operationEncode.orderId = orderIdEncode;
+        operationEncode.origOrderId = origOrderIdEncode;
         operationEncode.quantity = quantityEncode;
         operationEncode.price = priceEncode;
-        operationEncode.direction = operation.direction;
 
-        operationEncodeStream.write(operationEncode);
+        if(cancelOperation)
+        {
+            operationEncodeCancelStream.write(operationEncode);
+        }
+        else
+        {
+            operationEncodeStream.write(operationEncode);
+        }
     }
 
     return;
@@ -94,7 +219,6 @@ void OrderEntry::openListenPortTcp(hls::stream<ipTcpListenPortPack_t> &listenPor
 
     ipTcpListenPortPack_t listenPortPack;
     ipTcpListenStatusPack_t listenStatusPack;
-    bool listenDone = false;
 
     static ap_uint<2> state=0;
 #pragma HLS RESET variable=state
@@ -139,131 +263,223 @@ void OrderEntry::openActivePortTcp(ap_uint<32> &regControl,
                                    ap_uint<32> &regDestAddress,
                                    ap_uint<32> &regDestPort,
                                    ap_uint<32> &regDebug,
+                                   ap_uint<32> &regSessionConnected,
+                                   ap_uint<32> regSessionDestAddress[OE_NUM_SESSION],
+                                   ap_uint<32> regSessionDestPort[OE_NUM_SESSION],
                                    hls::stream<ipTuplePack_t> &openConnectionStream,
                                    hls::stream<ipTcpConnectionStatusPack_t> &connectionStatusStream,
                                    hls::stream<ipTcpCloseConnectionPack_t> &closeConnectionStream,
-                                   hls::stream<ipTcpTxStatusPack_t> &txStatusStream)
+                                   hls::stream<ipTcpTxStatusPack_t> &txStatusStream,
+                                   hls::stream<orderEntrySessionMap_t> &sessionMapStream)
 {
 #pragma HLS PIPELINE II=1 style=flp
 
     mmInterface intf;
     ipTuple_t tuple;
     ipTuplePack_t tuplePack;
+    ipTcpConnectionStatus_t connectionStatus;
     ipTcpTxStatus_t txStatus;
     ipTcpTxStatusPack_t txStatusPack;
     ipTcpCloseConnectionPack_t closeConnectionPack;
     ipTcpConnectionStatusPack_t connectionStatusPack;
+    ap_uint<1> sessionConnect;
+    ap_uint<32> sessionConnected;
+    orderEntrySessionMap_t sessionMap;
+    ap_uint<1> mapUpdate;
 
     enum stateType {IDLE, INIT_CON, WAIT_CON, ACTIVE_CON};
-    static stateType state=IDLE;
-    static ipTcpConnectionStatus_t connectionStatus;
-    static ap_uint<1>  statusConnected=0;
-    static ap_uint<16> statusLength=0;
-    static ap_uint<30> statusSpace=0;
-    static ap_uint<2>  statusError=0;
-    static ap_uint<16> statusSessionID=0;
+    static stateType state[OE_NUM_SESSION]={IDLE};
+    static ap_uint<1>  statusConnected[OE_NUM_SESSION]={0};
+    static ap_uint<16> statusLength[OE_NUM_SESSION]={0};
+    static ap_uint<30> statusSpace[OE_NUM_SESSION]={0};
+    static ap_uint<2>  statusError[OE_NUM_SESSION]={0};
+    static ap_uint<16> statusSessionID[OE_NUM_SESSION]={0};
+    static ap_uint<32> statusAcked[OE_NUM_SESSION]={0};
+    static ap_uint<1>  mapConnected[OE_NUM_SESSION]={0};
+    static ap_uint<16> mapSessionID[OE_NUM_SESSION]={0};
+#pragma HLS ARRAY_PARTITION variable=state complete
+#pragma HLS ARRAY_PARTITION variable=statusConnected complete
+#pragma HLS ARRAY_PARTITION variable=statusLength complete
+#pragma HLS ARRAY_PARTITION variable=statusSpace complete
+#pragma HLS ARRAY_PARTITION variable=statusError complete
+#pragma HLS ARRAY_PARTITION variable=statusSessionID complete
+#pragma HLS ARRAY_PARTITION variable=statusAcked complete
+
+    // connect state machines are serviced round robin one session per cycle,
+    // connection status responses from the TCP kernel carry no request tag
+    // and return in request order so a single open is kept outstanding
+    static ap_uint<8> session=0;
+    static ap_uint<8> openSession=0;
+    static ap_uint<1> openPending=0;
 
     static ap_uint<32> countDebug=0;
 
+    // transmit status is matched to the owning session by TCP session ID, the
+    // reported space already accounts for the message it acknowledges, the
+    // running total of acknowledged bytes lets the sender deduct only those
+    // messages still awaiting a status from the space reported
     if(!txStatusStream.empty())
     {
         txStatusPack = txStatusStream.read();
         intf.ipTcpTxStatusStreamUnpack(&txStatusPack, &txStatus);
-        statusLength = txStatus.length;
-        statusSpace = txStatus.space;
-        statusError = txStatus.error;
+
+loop_session_tx_status:
+        for(int i=0; i<OE_NUM_SESSION; i++)
+        {
+            if(statusConnected[i] && (txStatus.sessionID == statusSessionID[i]))
+            {
+                statusLength[i] = txStatus.length;
+                statusSpace[i] = txStatus.space;
+                statusError[i] = txStatus.error;
+                statusAcked[i] += txStatus.length;
+            }
+        }
     }
 
-    switch(state)
+    if(openPending && !connectionStatusStream.empty())
+    {
+        countDebug = (countDebug | 0x00004000);
+        connectionStatusPack = connectionStatusStream.read();
+        intf.ipTcpConnectionStatusUnpack(&connectionStatusPack, &connectionStatus);
+        openPending = 0;
+        if(connectionStatus.success)
+        {
+            countDebug = (countDebug | 0x00050000);
+            state[openSession] = ACTIVE_CON;
+            statusConnected[openSession] = 0x1;
+            statusLength[openSession] = 0x0;
+            statusSpace[openSession] = 0xffff;
+            statusError[openSession] = TXSTATUS_SUCCESS;
+            statusSessionID[openSession] = connectionStatus.sessionID;
+            statusAcked[openSession] = 0x0;
+        }
+    }
+
+    // session 0 is configured through the control registers, further sessions
+    // are only brought up once the host has programmed a destination port
+    if(0 == session)
+    {
+        tuple.address = regDestAddress;
+        tuple.port = regDestPort;
+        sessionConnect = ((OE_TCP_CONNECT & regControl) ? 1 : 0);
+    }
+    else
+    {
+        tuple.address = regSessionDestAddress[session];
+        tuple.port = regSessionDestPort[session];
+        sessionConnect = (((OE_TCP_CONNECT & regControl) && (0 != regSessionDestPort[session])) ? 1 : 0);
+    }
+
+    switch(state[session])
     {
         case IDLE:
         {
-            if(OE_TCP_CONNECT & regControl)
+            if(sessionConnect)
             {
                 countDebug = (countDebug | 0x00000001);
-                state = INIT_CON;
+                state[session] = INIT_CON;
             }
             break;
         }
         case INIT_CON:
         {
             countDebug = (countDebug | 0x00000020);
-            tuple.address = regDestAddress;
-            tuple.port = regDestPort;
-            intf.ipTuplePack(&tuple, &tuplePack);
-            tuplePack.last = 1;
-            tuplePack.keep = 0x3F;
-            openConnectionStream.write(tuplePack);
-
-            state = WAIT_CON;
+            if(!openPending)
+            {
+                intf.ipTuplePack(&tuple, &tuplePack);
+                tuplePack.last = 1;
+                tuplePack.keep = 0x3F;
+                openConnectionStream.write(tuplePack);
+                openPending = 1;
+                openSession = session;
+                state[session] = WAIT_CON;
+            }
             break;
         }
         case WAIT_CON:
         {
             countDebug = (countDebug | 0x00000300);
-            if(!connectionStatusStream.empty())
-            {
-                countDebug = (countDebug | 0x00004000);
-                connectionStatusPack = connectionStatusStream.read();
-                intf.ipTcpConnectionStatusUnpack(&connectionStatusPack, &connectionStatus);
-                if(connectionStatus.success)
-                {
-                    countDebug = (countDebug | 0x00050000);
-                    state = ACTIVE_CON;
-                    statusConnected = 0x1;
-                    statusLength = 0x0;
-                    statusSpace = 0xffff;
-                    statusError = TXSTATUS_SUCCESS;
-                    statusSessionID = connectionStatus.sessionID;
-                }
-            }
             // This code added to allow reconnect or disconnect to get out of WAIT_CON state
             // Note 0x007 instead of 0x006 to show this path was taken.
-            if(0 == (OE_TCP_CONNECT & regControl))
+            if(!sessionConnect)
             {
                 countDebug = (countDebug | 0x00700000);
-                state = IDLE;
-                statusConnected = 0x0;
-                statusLength = 0x0;
-                statusSpace = 0x0;
-                statusError = TXSTATUS_CLOSED;
+                state[session] = IDLE;
+                statusConnected[session] = 0x0;
+                statusLength[session] = 0x0;
+                statusSpace[session] = 0x0;
+                statusError[session] = TXSTATUS_CLOSED;
             }
             break;
         }
         case ACTIVE_CON:
         {
             countDebug = (countDebug | 0x00600000);
-            if(0 == (OE_TCP_CONNECT & regControl))
+            if(!sessionConnect)
             {
                 countDebug = (countDebug | 0x07000000);
-                closeConnectionPack.data = connectionStatus.sessionID;
+                closeConnectionPack.data = statusSessionID[session];
                 closeConnectionPack.keep = 0x3;
                 closeConnectionPack.last = 1;
                 closeConnectionStream.write(closeConnectionPack);
-                state = IDLE;
-                statusConnected = 0x0;
-                statusLength = 0x0;
-                statusSpace = 0x0;
-                statusError = TXSTATUS_CLOSED;
+                state[session] = IDLE;
+                statusConnected[session] = 0x0;
+                statusLength[session] = 0x0;
+                statusSpace[session] = 0x0;
+                statusError[session] = TXSTATUS_CLOSED;
             }
             break;
         }
         default:
         {
             countDebug = (countDebug | 0x80000000);
-            state = IDLE;
+            state[session] = IDLE;
             break;
         }
     }
 
+    session = ((session + 1) & (OE_NUM_SESSION-1));
+
     // single point of update for private struct
-    mConnectionStatus.connected = statusConnected;
-    mConnectionStatus.length = statusLength;
-    mConnectionStatus.space = statusSpace;
-    mConnectionStatus.error = statusError;
-    mConnectionStatus.sessionID = statusSessionID;
+    sessionConnected = 0;
+loop_session_status:
+    for(int i=0; i<OE_NUM_SESSION; i++)
+    {
+        mConnectionStatus[i].connected = statusConnected[i];
+        mConnectionStatus[i].length = statusLength[i];
+        mConnectionStatus[i].space = statusSpace[i];
+        mConnectionStatus[i].error = statusError[i];
+        mConnectionStatus[i].sessionID = statusSessionID[i];
+        mConnectionStatus[i].acked = statusAcked[i];
+        sessionConnected.range(i,i) = statusConnected[i];
+    }
+
+    // forward at most one session map change per call, the receive process
+    // sees a connect a few cycles after it completes, well ahead of any
+    // segment the peer can send in reply
+    mapUpdate = 0;
+loop_session_map:
+    for(int i=0; i<OE_NUM_SESSION; i++)
+    {
+        if(!mapUpdate &&
+           ((statusConnected[i] != mapConnected[i]) || (statusSessionID[i] != mapSessionID[i])))
+        {
+            sessionMap.session = i;
+            sessionMap.sessionID = statusSessionID[i];
+            sessionMap.connected = statusConnected[i];
+            mapUpdate = 1;
+        }
+    }
+
+    if(mapUpdate && !sessionMapStream.full())
+    {
+        sessionMapStream.write(sessionMap);
+        mapConnected[sessionMap.session] = sessionMap.connected;
+        mapSessionID[sessionMap.session] = sessionMap.sessionID;
+    }
 
     regDebug = countDebug;
+    regSessionConnected = sessionConnected;
 }
 
 void OrderEntry::notificationHandlerTcp(ap_uint<32> &regNotification,
@@ -303,22 +519,46 @@ void OrderEntry::notificationHandlerTcp(ap_uint<32> &regNotification,
     regReadRequest = countReadRequest;
 }
 
-void OrderEntry::serverProcessTcp(ap_uint<32> &regRxData,
+void OrderEntry::serverProcessTcp(ap_uint<32> &regProtocol,
+                                  ap_uint<32> &regRxData,
                                   ap_uint<32> &regRxMeta,
                                   hls::stream<ipTcpRxMetaPack_t> &rxMetaStream,
-                                  hls::stream<ipTcpRxDataPack_t> &rxDataStream)
+                                  hls::stream<ipTcpRxDataPack_t> &rxDataStream,
+                                  hls::stream<orderEntrySessionMap_t> &sessionMapStream,
+                                  hls::stream<orderEntryExecReport_t> &execReportStream)
 {
 #pragma HLS PIPELINE II=1 style=flp
 
     ipTcpRxMetaPack_t rxMetaPack;
     ap_uint<16> sessionID;
     ap_axiu<64,0,0,0> currWord;
+    ap_uint<8> rxByte;
+    orderEntryExecReport_t execReport, byteReport;
+    bool reportValid;
+    orderEntrySessionMap_t sessionMap;
 
     static ap_uint<1> state=0;
+    static ap_uint<8> session=0;
+    static ap_uint<1> protocolBinary=0;
+    static orderEntryRxContext_t context;
+    static orderEntryRxContext_t rxContext[OE_NUM_SESSION];
+#pragma HLS ARRAY_PARTITION variable=rxContext complete
+    static ap_uint<1>  mapConnected[OE_NUM_SESSION]={0};
+    static ap_uint<16> mapSessionID[OE_NUM_SESSION]={0};
+#pragma HLS ARRAY_PARTITION variable=mapConnected complete
+#pragma HLS ARRAY_PARTITION variable=mapSessionID complete
 
     static ap_uint<32> countRxData=0;
     static ap_uint<32> countRxMeta=0;
 
+    // local copy of the session map, maintained from the connection process
+    if(!sessionMapStream.empty())
+    {
+        sessionMap = sessionMapStream.read();
+        mapConnected[sessionMap.session] = sessionMap.connected;
+        mapSessionID[sessionMap.session] = sessionMap.sessionID;
+    }
+
     switch(state)
     {
         case 0:
@@ -328,6 +568,21 @@ void OrderEntry::serverProcessTcp(ap_uint<32> &regRxData,
                 rxMetaPack = rxMetaStream.read();
                 ++countRxMeta;
                 sessionID = rxMetaPack.data;
+
+                // segment belongs to the session with a matching TCP session
+                // ID, parser state for that session is restored so a message
+                // split across segments is picked up where it left off
+                session = 0;
+loop_rx_session:
+                for(int i=0; i<OE_NUM_SESSION; i++)
+                {
+                    if(mapConnected[i] && (sessionID == mapSessionID[i]))
+                    {
+                        session = i;
+                    }
+                }
+                protocolBinary = ((regProtocol >> session) & OE_PROTOCOL_BINARY);
+                context = rxContext[session];
                 state = 1;
             }
             break;
@@ -338,8 +593,44 @@ void OrderEntry::serverProcessTcp(ap_uint<32> &regRxData,
             {
                 currWord = rxDataStream.read();
                 ++countRxData;
+
+                // execution reports are extracted on the fly with the first
+                // byte in the lowest lane, reports are always longer than a
+                // word so at most one completes per word
+                reportValid = false;
+loop_rx_byte:
+                for(int i=0; i<OE_MSG_WORD_BYTES; i++)
+                {
+                    if(currWord.keep.range(i,i))
+                    {
+                        rxByte = currWord.data.range((i*8)+7,(i*8));
+                        if(protocolBinary)
+                        {
+                            if(rxParseBinary(context, rxByte, byteReport))
+                            {
+                                execReport = byteReport;
+                                reportValid = true;
+                            }
+                        }
+                        else
+                        {
+                            if(rxParseFix(context, rxByte, byteReport))
+                            {
+                                execReport = byteReport;
+                                reportValid = true;
+                            }
+                        }
+                    }
+                }
+
+                if(reportValid)
+                {
+                    execReportStream.write(execReport);
+                }
+
                 if(currWord.last)
                 {
+                    rxContext[session] = context;
                     state = 0;
                 }
             }
@@ -351,6 +642,50 @@ void OrderEntry::serverProcessTcp(ap_uint<32> &regRxData,
     regRxMeta = countRxMeta;
 }
 
+void OrderEntry::executionReportDecode(ap_uint<32> &regRxFill,
+                                       hls::stream<orderEntryExecReport_t> &execReportStream,
+                                       hls::stream<orderEntryFillPack_t> &fillStream)
+{
+#pragma HLS PIPELINE II=1 style=flp
+
+    mmInterface intf;
+    orderEntryExecReport_t execReport;
+    orderEntryFill_t fill;
+    orderEntryFillPack_t fillPack;
+
+    // LastPx scaled to fixed point by the number of decimal places received
+    const ap_uint<17> priceScale[OE_PRICE_DECIMALS+1] = {100000, 10000, 1000, 100, 10, 1};
+
+    static ap_uint<32> countRxFill=0;
+
+    if(!execReportStream.empty())
+    {
+        execReport = execReportStream.read();
+
+        if(execReport.binary)
+        {
+            fill.orderId = execReport.orderId.range(31,0);
+            fill.quantity = execReport.quantity.range(31,0);
+            fill.price = execReport.price.range(31,0);
+        }
+        else
+        {
+            fill.orderId = bcdToUint32(execReport.orderId);
+            fill.quantity = bcdToUint32(execReport.quantity);
+            fill.price = (bcdToUint32(execReport.price) * priceScale[execReport.priceDecimals]);
+        }
+        fill.execType = execReport.execType;
+
+        intf.orderEntryFillPack(&fill, &fillPack);
+        fillStream.write(fillPack);
+        ++countRxFill;
+    }
+
+    regRxFill = countRxFill;
+
+    return;
+}
+
 void OrderEntry::operationProcessTcp(ap_uint<32> &regControl,
                                      ap_uint<32> &regCaptureControl,
                                      ap_uint<32> &regProcessOperation,
@@ -359,184 +694,478 @@ void OrderEntry::operationProcessTcp(ap_uint<32> &regControl,
                                      ap_uint<32> &regTxMeta,
                                      ap_uint<32> &regTxStatus,
                                      ap_uint<32> &regTxDrop,
-                                     ap_uint<1024> &regCaptureBuffer,
+                                     ap_uint<32> &regTxStall,
+                                     ap_uint<32> &regTraceDrop,
+                                     ap_uint<OE_MSG_CAPTURE_BITS> &regCaptureBuffer,
+                                     hls::stream<orderEntryOperationEncode_t> &operationTxStream,
+                                     hls::stream<orderEntryOperationEncode_t> &operationTxCancelStream,
                                      hls::stream<orderEntryOperationEncode_t> &operationEncodeStream,
+                                     hls::stream<orderEntryOperationEncode_t> &operationEncodeCancelStream,
                                      hls::stream<ipTcpTxMetaPack_t> &txMetaStream,
-                                     hls::stream<ipTcpTxDataPack_t> &txDataStream)
+                                     hls::stream<ipTcpTxDataPack_t> &txDataStream,
+                                     hls::stream<orderEntryTraceEntry_t> &traceStream)
 {
 #pragma HLS PIPELINE II=1 style=flp
 
     mmInterface intf;
-    orderEntryOperationEncode_t operationEncode;
-    orderEntryMessagePack_t messagePack;
+    orderEntryOperationEncode_t operation, operationEncode;
+    orderEntryField_t field;
+    orderEntryMessageHeader_t messageHeader;
     ipTcpTxMeta_t txMeta;
     ipTcpTxMetaPack_t txMetaPack;
 
-    ap_uint<16> sessionID;
+    ap_uint<8> session;
     ap_uint<16> length;
+    ap_uint<8> fieldByte;
+    ap_uint<4> fieldLength;
+    ap_uint<9> byteIndex;
+    ap_uint<1> fieldEncoded;
+    ap_uint<24> checksumAscii;
     ap_uint<64> frameData;
     ap_uint<32> rangeIndexHigh, rangeIndexLow;
     ap_axiu<64,0,0,0> messageWord;
-    ap_uint<24> orderIdSum, timestampSum, quantitySum, priceSum, messageSum;
-    ap_uint<1> validSum;
+    ap_uint<32> outstanding, credit;
+    ap_uint<1> validType, validOperation=0, cancelOperation=0, validEncode=0;
+    ap_uint<1> releaseOperation=0;
 
     static ap_uint<32> countProcessOperation=0;
     static ap_uint<32> countTxOrder=0;
     static ap_uint<32> countTxData=0;
     static ap_uint<32> countTxMeta=0;
     static ap_uint<32> countTxDrop=0;
+    static ap_uint<32> countTxStall=0;
+    static ap_uint<32> countTraceDrop=0;
     static ap_uint<32> countDebug=0;
+    static ap_uint<64> countCycles=0;
+    static ap_uint<32> countSequence[OE_NUM_SESSION]={0};
+    static ap_uint<32> countTxBytes[OE_NUM_SESSION]={0};
+    static ap_uint<1> connectedPrev[OE_NUM_SESSION]={0};
+    static ap_uint<8> sessionStatus=0;
+#pragma HLS ARRAY_PARTITION variable=countSequence complete
+#pragma HLS ARRAY_PARTITION variable=countTxBytes complete
+#pragma HLS ARRAY_PARTITION variable=connectedPrev complete
+
+    // one cancel and one order may be held waiting for transmit credit, an
+    // operation leaves its slot only once sent or found unsendable
+    static orderEntryOperationEncode_t heldCancel, heldOrder;
+    static ap_uint<1> heldCancelValid=0, heldOrderValid=0;
+
+    // message under transmission, frames are sent one per cycle from the
+    // prefix that is complete at selection up to the cut frame holding the
+    // first ASCII encoded field, the remainder follows once the encoded
+    // fields of the operation arrive
+    enum stateType {IDLE, SEND};
+    static stateType state=IDLE;
+    static ap_uint<8> message[OE_MSG_MAX_BYTES];
+    static ap_uint<8> messageType=0;
+    static ap_uint<16> messageLength=0;
+    static ap_uint<16> messageSessionID=0;
+    static ap_uint<1> messageCancel=0;
+    static ap_uint<1> messageBinary=0;
+    static ap_uint<1> messageComplete=0;
+    static ap_uint<1> messageMeta=0;
+    static ap_uint<6> numFrame=0;
+    static ap_uint<6> cutFrame=0;
+    static ap_uint<6> frameCount=0;
+    static ap_uint<4> lastBytes=0;
+    static ap_uint<32> fieldSum=0;
+    static ap_uint<8> byteSum=0;
+    static ap_uint<24> messageSum=0;
+    static ap_uint<OE_MSG_CAPTURE_BITS> messageCapture=0;
+    static orderEntryTraceEntry_t traceEntry;
+    static ap_uint<8> discardOrder=0, discardCancel=0;
+#pragma HLS ARRAY_PARTITION variable=message complete
+
+    // message sequence numbers restart from one on every new connection, as
+    // does the count of bytes sent against the session transmit credit
+loop_session_sequence:
+    for(int i=0; i<OE_NUM_SESSION; i++)
+    {
+        if(mConnectionStatus[i].connected && !connectedPrev[i])
+        {
+            countSequence[i] = 0;
+            countTxBytes[i] = 0;
+        }
+        connectedPrev[i] = mConnectionStatus[i].connected;
+    }
 
-    if(!operationEncodeStream.empty())
+    if(!heldCancelValid && !operationTxCancelStream.empty())
     {
-        operationEncode = operationEncodeStream.read();
+        heldCancel = operationTxCancelStream.read();
+        heldCancelValid = 1;
         ++countProcessOperation;
+    }
 
-        // egress message is transmitted on data interface as 64b words
-        messageWord.last = 0;
-        messageWord.strb = 0xFF;
-        messageWord.keep = 0xFF;
-        txMetaPack.last = 0;
-        txMetaPack.keep = 0x7F;
-
-        // currently static as we send a fixed message size
-        sessionID = mConnectionStatus.sessionID;
-        length = OE_MSG_LEN_BYTES;
-
-        // apply field updates to overwrite template fields
-        messageTemplate[3].range(63,0) = operationEncode.orderId.range(79,16);
-        messageTemplate[4].range(63,48) = operationEncode.orderId.range(15,0);
-        messageTemplate[9].range(63,0) = operationEncode.timestamp;
-        messageTemplate[15].range(31,0) = operationEncode.orderId.range(79,48);
-        messageTemplate[16].range(63,16) = operationEncode.orderId.range(47,0);
-        messageTemplate[17].range(47,0) = operationEncode.quantity.range(79,32);
-        messageTemplate[18].range(63,32) = operationEncode.quantity.range(31,0);
-        messageTemplate[19].range(23,0) = operationEncode.price.range(79,56);
-        messageTemplate[20].range(63,8) = operationEncode.price.range(55,0);
-
-        // if checksum generation is enabled we calculate the partial sum for
-        // the payload here and send to TCP kernel via metadata interface, this
-        // reduces latency as TCP can begin sending in cut-through mode rather
-        // than buffer the full packet in store and forward mode
-        if(OE_TCP_GEN_SUM & regControl)
-        {
-            timestampSum = operationEncode.timestamp.range(15,0);
-            timestampSum += operationEncode.timestamp.range(31,16);
-            timestampSum = (timestampSum + (timestampSum>>16)) & 0xFFFF;
-            timestampSum += operationEncode.timestamp.range(47,32);
-            timestampSum = (timestampSum + (timestampSum>>16)) & 0xFFFF;
-            timestampSum += operationEncode.timestamp.range(63,48);
-            timestampSum = (timestampSum + (timestampSum>>16)) & 0xFFFF;
-
-            orderIdSum = operationEncode.orderId.range(15,0);
-            orderIdSum += operationEncode.orderId.range(31,16);
-            orderIdSum = (orderIdSum + (orderIdSum>>16)) & 0xFFFF;
-            orderIdSum += operationEncode.orderId.range(47,32);
-            orderIdSum = (orderIdSum + (orderIdSum>>16)) & 0xFFFF;
-            orderIdSum += operationEncode.orderId.range(63,48);
-            orderIdSum = (orderIdSum + (orderIdSum>>16)) & 0xFFFF;
-            orderIdSum += operationEncode.orderId.range(79,64);
-            orderIdSum = (orderIdSum + (orderIdSum>>16)) & 0xFFFF;
-
-            quantitySum = operationEncode.quantity.range(15,0);
-            quantitySum += operationEncode.quantity.range(31,16);
-            quantitySum = (quantitySum + (quantitySum>>16)) & 0xFFFF;
-            quantitySum += operationEncode.quantity.range(47,32);
-            quantitySum = (quantitySum + (quantitySum>>16)) & 0xFFFF;
-            quantitySum += operationEncode.quantity.range(63,48);
-            quantitySum = (quantitySum + (quantitySum>>16)) & 0xFFFF;
-            quantitySum += operationEncode.quantity.range(79,64);
-            quantitySum = (quantitySum + (quantitySum>>16)) & 0xFFFF;
-
-            // the price field is not 16b aligned, need to shift by one byte
-            priceSum = (operationEncode.price.range(7,0) << 8);
-            priceSum += operationEncode.price.range(23,8);
-            priceSum = (priceSum + (priceSum>>16)) & 0xFFFF;
-            priceSum += operationEncode.price.range(39,24);
-            priceSum = (priceSum + (priceSum>>16)) & 0xFFFF;
-            priceSum += operationEncode.price.range(55,40);
-            priceSum = (priceSum + (priceSum>>16)) & 0xFFFF;
-            priceSum += operationEncode.price.range(71,56);
-            priceSum = (priceSum + (priceSum>>16)) & 0xFFFF;
-            priceSum += operationEncode.price.range(79,72);
-            priceSum = (priceSum + (priceSum>>16)) & 0xFFFF;
-
-            // merge template message partial sum with dynamic field updates
-            messageSum = messageTemplateSum;
-            messageSum += orderIdSum;
-            messageSum = (messageSum + (messageSum>>16)) & 0xFFFF;
-            messageSum += timestampSum;
-            messageSum = (messageSum + (messageSum>>16)) & 0xFFFF;
-            messageSum += orderIdSum;
-            messageSum = (messageSum + (messageSum>>16)) & 0xFFFF;
-            messageSum += quantitySum;
-            messageSum = (messageSum + (messageSum>>16)) & 0xFFFF;
-            messageSum += priceSum;
-            messageSum = (messageSum + (messageSum>>16)) & 0xFFFF;
-            validSum = 1;
+    if(!heldOrderValid && !operationTxStream.empty())
+    {
+        heldOrder = operationTxStream.read();
+        heldOrderValid = 1;
+        ++countProcessOperation;
+    }
+
+    if(IDLE == state)
+    {
+        // a waiting cancel always takes priority, a cancel may therefore
+        // overtake a new order for the same orderId still queued here, the
+        // gateway rejects such a cancel and the order is left working
+        if(heldCancelValid)
+        {
+            operation = heldCancel;
+            validOperation = 1;
+            cancelOperation = 1;
+        }
+        else if(heldOrderValid)
+        {
+            operation = heldOrder;
+            validOperation = 1;
+        }
+    }
+
+    if(validOperation)
+    {
+        // opCode selects the message template
+        validType = 1;
+        switch(operation.opCode)
+        {
+            case ORDERENTRY_ADD:
+                messageType = OE_MSG_NEW_ORDER;
+                break;
+            case ORDERENTRY_MODIFY:
+                messageType = OE_MSG_CANCEL_REPLACE;
+                break;
+            case ORDERENTRY_DELETE:
+                messageType = OE_MSG_CANCEL;
+                break;
+            default:
+                messageType = OE_MSG_NEW_ORDER;
+                validType = 0;
+                break;
+        }
+
+        if(operation.binary)
+        {
+            messageType += OE_MSG_BIN_NEW_ORDER;
+        }
+
+        session = operation.session;
+        sessionStatus = session;
+        length = messageTemplateLength[messageType];
+
+        // transmit credit is the space last reported by the TCP kernel less
+        // bytes sent since that have yet to be acknowledged by a status, an
+        // operation without credit is held rather than dropped and applies
+        // backpressure through the queues
+        outstanding = (countTxBytes[session] - mConnectionStatus[session].acked);
+        if(outstanding < mConnectionStatus[session].space)
+        {
+            credit = (mConnectionStatus[session].space - outstanding);
         }
         else
         {
-            messageSum = 0;
-            validSum = 0;
+            credit = 0;
         }
 
-        if((mConnectionStatus.connected) &&
-           (length <= mConnectionStatus.space) &&
-           (TXSTATUS_SUCCESS == mConnectionStatus.error))
+        if((!validType) ||
+           (!mConnectionStatus[session].connected) ||
+           (TXSTATUS_SUCCESS != mConnectionStatus[session].error))
         {
-            // send the meta data
-            txMeta.validSum = validSum;
-            txMeta.subSum = messageSum;
-            txMeta.sessionID = sessionID;
-            txMeta.length = length;
-            intf.ipTcpTxMetaPack(&txMeta, &txMetaPack);
-            txMetaPack.last = 1;
-            txMetaStream.write(txMetaPack);
-            ++countTxMeta;
+            // no session can accept this operation, release the slot, the
+            // encoded fields of a FIX operation are still to be discarded
+            ++countTxDrop;
+            releaseOperation = 1;
+            if(!operation.binary)
+            {
+                if(cancelOperation)
+                {
+                    ++discardCancel;
+                }
+                else
+                {
+                    ++discardOrder;
+                }
+            }
+        }
+        else if(length > credit)
+        {
+            ++countTxStall;
+        }
+        else
+        {
+            releaseOperation = 1;
+
+            // messages are sent at their true length, final frame may be
+            // partial, the sequence number is consumed on selection
+            messageLength = length;
+            messageSessionID = mConnectionStatus[session].sessionID;
+            messageCancel = cancelOperation;
+            messageBinary = operation.binary;
+            messageComplete = 0;
+            messageMeta = 0;
+            numFrame = ((length + (OE_MSG_WORD_BYTES-1)) >> 3);
+            lastBytes = (length - ((numFrame-1) << 3));
+            cutFrame = numFrame;
+            frameCount = 0;
+            messageCapture = 0;
+
+            traceEntry.timestamp = operation.timestamp;
+            traceEntry.sessionID = messageSessionID;
+            traceEntry.session = session;
+            traceEntry.length = length;
+            traceEntry.opCode = operation.opCode;
+            traceEntry.symbolIndex = operation.symbolIndex;
+            traceEntry.message = 0;
+
+            messageHeader.sequence = (countSequence[session] + 1);
+            messageHeader.sequenceAscii = uint32ToAscii(messageHeader.sequence);
+            messageHeader.bodyLength = chunkToAscii(messageBodyLength[messageType]).range(23,0);
+            sendingTimeFormat(mSendingTime, messageHeader.sendingDate, messageHeader.sendingTime);
+            countSequence[session] = messageHeader.sequence;
+            countTxBytes[session] += length;
+            traceEntry.sequence = messageHeader.sequence;
+
+loop_message_load:
+            for(int byteCount=0; byteCount<OE_MSG_MAX_BYTES; byteCount++)
+            {
+                message[byteCount] = messageTemplate[messageType][byteCount];
+            }
+
+            // apply field updates to overwrite template fields, the checksum
+            // change for each overwritten byte is accumulated in the same pass
+            // for both the TCP partial sum and the FIX message checksum, ASCII
+            // encoded fields are deferred and mark the cut frame
+            fieldSum = 0;
+            byteSum = messageTemplateByteSum[messageType];
 
-loop_message_frame:
-            for(int frameCount=0; frameCount<OE_MSG_NUM_FRAME; frameCount++)
+loop_message_field:
+            for(int fieldCount=0; fieldCount<OE_MSG_NUM_FIELD; fieldCount++)
             {
-                // load frame from template
-                frameData = messageTemplate[frameCount];
+                field = messageField[messageType][fieldCount];
+                fieldLength = messageFieldLength(field.id);
+                fieldEncoded = messageFieldEncoded(field.id);
 
-                // reverse for network byte order in egress message payload
-                messageWord.data = byteReverse(frameData);
+                if(fieldEncoded && ((field.offset >> 3) < cutFrame))
+                {
+                    cutFrame = (field.offset >> 3);
+                }
 
-                // instruct tcp kernel if this is the last frame in payload
-                if(31 == frameCount)
+loop_message_field_byte:
+                for(int byteCount=0; byteCount<OE_MSG_FIELD_BYTES; byteCount++)
                 {
-                    messageWord.last = 1;
-                    ++countDebug;
+                    if(!fieldEncoded && (byteCount < fieldLength))
+                    {
+                        byteIndex = (field.offset + byteCount);
+                        fieldByte = messageFieldByte(operation, messageHeader, field.id, byteCount);
+                        fieldSum += checksumUpdate(byteIndex, message[byteIndex], fieldByte);
+                        byteSum += (fieldByte - message[byteIndex]);
+                        message[byteIndex] = fieldByte;
+                    }
                 }
+            }
 
-                // forward frame to tcp kernel
-                txDataStream.write(messageWord);
-                ++countTxData;
+            // the TCP partial sum covers every byte and the metadata carrying
+            // it must lead the payload, with checksum generation enabled the
+            // message is held whole until the encoded fields are applied
+            if(OE_TCP_GEN_SUM & regControl)
+            {
+                cutFrame = 0;
+            }
+
+            state = SEND;
+        }
+
+        if(releaseOperation)
+        {
+            if(cancelOperation)
+            {
+                heldCancelValid = 0;
+            }
+            else
+            {
+                heldOrderValid = 0;
+            }
+        }
+    }
+
+    // encoded fields arrive in the order operations were selected for each
+    // class, fields of a FIX operation dropped before transmission are read
+    // and discarded ahead of those of the message being sent
+    if((0 != discardCancel) ||
+       ((SEND == state) && !messageComplete && !messageBinary && messageCancel && (frameCount == cutFrame)))
+    {
+        if(!operationEncodeCancelStream.empty())
+        {
+            operationEncode = operationEncodeCancelStream.read();
+            if(0 != discardCancel)
+            {
+                --discardCancel;
+            }
+            else
+            {
+                validEncode = 1;
+            }
+        }
+    }
+    else if((0 != discardOrder) ||
+            ((SEND == state) && !messageComplete && !messageBinary && !messageCancel && (frameCount == cutFrame)))
+    {
+        if(!operationEncodeStream.empty())
+        {
+            operationEncode = operationEncodeStream.read();
+            if(0 != discardOrder)
+            {
+                --discardOrder;
+            }
+            else
+            {
+                validEncode = 1;
+            }
+        }
+    }
 
-                // add frame to message capture
-                rangeIndexLow = (frameCount*64);
-                rangeIndexHigh = (rangeIndexLow+63);
-                if(rangeIndexHigh < 1024)
+    if(SEND == state)
+    {
+        if(validEncode)
+        {
+loop_message_field_encoded:
+            for(int fieldCount=0; fieldCount<OE_MSG_NUM_FIELD; fieldCount++)
+            {
+                field = messageField[messageType][fieldCount];
+                fieldLength = messageFieldLength(field.id);
+                fieldEncoded = messageFieldEncoded(field.id);
+
+loop_message_field_encoded_byte:
+                for(int byteCount=0; byteCount<OE_MSG_FIELD_BYTES; byteCount++)
                 {
-                    // TODO: add 2048b message capture support, truncate for now
-                    messagePack.data.range(rangeIndexHigh,rangeIndexLow) = frameData;
+                    if(fieldEncoded && (byteCount < fieldLength))
+                    {
+                        byteIndex = (field.offset + byteCount);
+                        fieldByte = messageFieldByte(operationEncode, messageHeader, field.id, byteCount);
+                        fieldSum += checksumUpdate(byteIndex, message[byteIndex], fieldByte);
+                        byteSum += (fieldByte - message[byteIndex]);
+                        message[byteIndex] = fieldByte;
+                    }
                 }
             }
+        }
 
-            ++countTxOrder;
-
-            // message capture recorded in register map for host visibility
-            // check if host has capture freeze control enabled before updating
-            if(0 == (OE_CAPTURE_FREEZE & regCaptureControl))
+        if(!messageComplete && (messageBinary || validEncode))
+        {
+            // FIX checksum (tag 10) is the byte sum modulo 256 of everything
+            // preceding the trailer, written as three digits before the final
+            // delimiter, the binary templates carry no trailer
+            if(!messageBinary)
             {
-                regCaptureBuffer = messagePack.data;
+                checksumAscii = chunkToAscii(byteSum).range(23,0);
+
+loop_message_checksum:
+                for(int byteCount=0; byteCount<3; byteCount++)
+                {
+                    byteIndex = ((messageLength - 4) + byteCount);
+                    fieldByte = checksumAscii.range((23-(byteCount*8)),(16-(byteCount*8)));
+                    fieldSum += checksumUpdate(byteIndex, message[byteIndex], fieldByte);
+                    message[byteIndex] = fieldByte;
+                }
             }
+
+            // apply dynamic field updates to the template message partial sum
+            fieldSum = (fieldSum & 0xFFFF) + (fieldSum>>16);
+            fieldSum = (fieldSum & 0xFFFF) + (fieldSum>>16);
+            messageSum = messageTemplateSum[messageType];
+            messageSum += fieldSum;
+            messageSum = (messageSum + (messageSum>>16)) & 0xFFFF;
+            messageComplete = 1;
         }
-        else
+
+        // if checksum generation is enabled we send the partial sum for the
+        // payload to TCP kernel via metadata interface, this reduces latency
+        // as TCP can begin sending in cut-through mode rather than buffer the
+        // full packet in store and forward mode, the metadata always leads
+        // the first frame, so prefix frames are only sent ahead of the
+        // encoded fields when checksum generation is disabled
+        if(!messageMeta && (messageComplete || !(OE_TCP_GEN_SUM & regControl)))
         {
-            ++countTxDrop;
+            txMeta.validSum = ((OE_TCP_GEN_SUM & regControl) ? 1 : 0);
+            txMeta.subSum = ((OE_TCP_GEN_SUM & regControl) ? (ap_uint<16>)messageSum : (ap_uint<16>)0);
+            txMeta.sessionID = messageSessionID;
+            txMeta.length = messageLength;
+            intf.ipTcpTxMetaPack(&txMeta, &txMetaPack);
+            txMetaPack.last = 1;
+            txMetaPack.keep = 0x7F;
+            txMetaStream.write(txMetaPack);
+            ++countTxMeta;
+            messageMeta = 1;
+        }
+
+        if(messageComplete || (frameCount < cutFrame))
+        {
+            // load frame from assembled message
+loop_message_frame_byte:
+            for(int byteCount=0; byteCount<OE_MSG_WORD_BYTES; byteCount++)
+            {
+                frameData.range((63-(byteCount*8)),(56-(byteCount*8))) = message[(frameCount*OE_MSG_WORD_BYTES)+byteCount];
+            }
+
+            // reverse for network byte order in egress message payload
+            messageWord.data = byteReverse(frameData);
+            messageWord.last = 0;
+            messageWord.strb = 0xFF;
+            messageWord.keep = 0xFF;
+
+            // instruct tcp kernel if this is the last frame in payload,
+            // first payload byte is in the lowest lane after reversal
+            if((numFrame-1) == frameCount)
+            {
+                messageWord.last = 1;
+                messageWord.keep = (0xFF >> (OE_MSG_WORD_BYTES-lastBytes));
+                messageWord.strb = messageWord.keep;
+                ++countDebug;
+            }
+
+            // forward frame to tcp kernel
+            txDataStream.write(messageWord);
+            ++countTxData;
+
+            // add frame to message capture and trace entry, capture is sized
+            // for the largest template so messages are held in full
+            rangeIndexLow = (frameCount*64);
+            rangeIndexHigh = (rangeIndexLow+63);
+            messageCapture.range(rangeIndexHigh,rangeIndexLow) = frameData;
+            traceEntry.message.range(rangeIndexHigh,rangeIndexLow) = messageWord.data;
+
+            if(0 == frameCount)
+            {
+                traceEntry.txTimestamp = countCycles;
+            }
+
+            if((numFrame-1) == frameCount)
+            {
+                ++countTxOrder;
+
+                // message capture recorded in register map for host visibility
+                // check if host has capture freeze control enabled before updating
+                if(0 == (OE_CAPTURE_FREEZE & regCaptureControl))
+                {
+                    regCaptureBuffer = messageCapture;
+                }
+
+                // trace must never hold up transmit, when the trace queue is
+                // full the message is sent but its entry is dropped
+                if(OE_TRACE_ENABLE & regControl)
+                {
+                    if(!traceStream.full())
+                    {
+                        traceStream.write(traceEntry);
+                    }
+                    else
+                    {
+                        ++countTraceDrop;
+                    }
+                }
+
+                state = IDLE;
+            }
+
+            ++frameCount;
         }
     }
 
@@ -545,10 +1174,468 @@ loop_message_frame:
     regTxData = countTxData;
     regTxMeta = countTxMeta;
     regTxDrop = countTxDrop;
+    regTxStall = countTxStall;
+    regTraceDrop = countTraceDrop;
+
+    ++countCycles;
+
+    // transmit status reflects the session of the most recent operation
+    regTxStatus.range(31,31) = mConnectionStatus[sessionStatus].connected;
+    regTxStatus.range(30,29) = mConnectionStatus[sessionStatus].error;
+    regTxStatus.range(28,0)  = mConnectionStatus[sessionStatus].space;
+
+    return;
+}
+
+void OrderEntry::messageTrace(ap_uint<32> &regTraceHead,
+                              ap_uint<32> &regTraceTail,
+                              ap_uint<512> traceRing[OE_TRACE_RING_LEN*OE_TRACE_ENTRY_WORDS],
+                              hls::stream<orderEntryTraceEntry_t> &traceStream)
+{
+#pragma HLS PIPELINE II=1 style=flp
+
+    orderEntryTraceEntry_t traceEntry;
+    ap_uint<512> traceWord;
+    ap_uint<32> ringIndex;
+
+    static ap_uint<32> countIndexTail=0;
+
+    // head and tail are free running entry counts, the ring slot is the count
+    // modulo ring length, an entry is only written while the host has left
+    // room so unread entries are never overwritten, a full ring holds entries
+    // in the trace queue and further entries are dropped at the transmitter
+    if((ap_uint<32>(countIndexTail - regTraceHead) < OE_TRACE_RING_LEN) && !traceStream.empty())
+    {
+        traceEntry = traceStream.read();
+
+        traceWord = 0;
+        traceWord.range(63,0) = traceEntry.txTimestamp;
+        traceWord.range(127,64) = traceEntry.timestamp;
+        traceWord.range(143,128) = traceEntry.sessionID;
+        traceWord.range(151,144) = traceEntry.session;
+        traceWord.range(167,152) = traceEntry.length;
+        traceWord.range(199,168) = traceEntry.sequence;
+        traceWord.range(207,200) = traceEntry.opCode;
+        traceWord.range(215,208) = traceEntry.symbolIndex;
+
+        // entry written as a single burst, header then message words
+        ringIndex = ((countIndexTail & (OE_TRACE_RING_LEN-1)) * OE_TRACE_ENTRY_WORDS);
+
+loop_trace_word:
+        for(int i=0; i<OE_TRACE_ENTRY_WORDS; i++)
+        {
+            if(0 != i)
+            {
+                traceWord = 0;
+                if(((i-1)*512) < OE_MSG_CAPTURE_BITS)
+                {
+                    traceWord = (traceEntry.message >> ((i-1)*512));
+                }
+            }
+            traceRing[ringIndex+i] = traceWord;
+        }
+
+        ++countIndexTail;
+    }
+
+    regTraceTail = countIndexTail;
+
+    return;
+}
+
+ap_uint<8> OrderEntry::messageFieldByte(orderEntryOperationEncode_t &operationEncode,
+                                        orderEntryMessageHeader_t &messageHeader,
+                                        ap_uint<8> fieldId,
+                                        ap_uint<4> byteIndex)
+{
+#pragma HLS INLINE
+
+    ap_uint<8> fieldByte=0;
+
+    // byteIndex zero is the first transmitted byte, most significant for
+    // ASCII fields and least significant for binary little endian fields
+    switch(fieldId)
+    {
+        case OE_FIELD_BODY_LENGTH:
+            fieldByte = messageHeader.bodyLength.range((23-(byteIndex*8)),(16-(byteIndex*8)));
+            break;
+        case OE_FIELD_SEQUENCE:
+            fieldByte = messageHeader.sequenceAscii.range((79-(byteIndex*8)),(72-(byteIndex*8)));
+            break;
+        case OE_FIELD_SENDING_DATE:
+            fieldByte = messageHeader.sendingDate.range((63-(byteIndex*8)),(56-(byteIndex*8)));
+            break;
+        case OE_FIELD_SENDING_TIME:
+            fieldByte = messageHeader.sendingTime.range((95-(byteIndex*8)),(88-(byteIndex*8)));
+            break;
+        case OE_FIELD_ORDER_ID:
+            fieldByte = operationEncode.orderId.range((79-(byteIndex*8)),(72-(byteIndex*8)));
+            break;
+        case OE_FIELD_ORIG_ORDER_ID:
+            fieldByte = operationEncode.origOrderId.range((79-(byteIndex*8)),(72-(byteIndex*8)));
+            break;
+        case OE_FIELD_QUANTITY:
+            fieldByte = operationEncode.quantity.range((79-(byteIndex*8)),(72-(byteIndex*8)));
+            break;
+        case OE_FIELD_PRICE:
+            fieldByte = operationEncode.price.range((87-(byteIndex*8)),(80-(byteIndex*8)));
+            break;
+        case OE_FIELD_SIDE:
+            // FIX Side(54), 1=Buy 2=Sell
+            fieldByte = ((ORDER_BID == operationEncode.direction) ? '1' : '2');
+            break;
+        case OE_FIELD_SEQUENCE_BIN:
+            fieldByte = messageHeader.sequence.range(((byteIndex*8)+7),(byteIndex*8));
+            break;
+        case OE_FIELD_TIMESTAMP_BIN:
+            fieldByte = operationEncode.timestamp.range(((byteIndex*8)+7),(byteIndex*8));
+            break;
+        case OE_FIELD_ORDER_ID_BIN:
+            fieldByte = operationEncode.orderId.range(((byteIndex*8)+7),(byteIndex*8));
+            break;
+        case OE_FIELD_ORIG_ORDER_ID_BIN:
+            fieldByte = operationEncode.origOrderId.range(((byteIndex*8)+7),(byteIndex*8));
+            break;
+        case OE_FIELD_QUANTITY_BIN:
+            fieldByte = operationEncode.quantity.range(((byteIndex*8)+7),(byteIndex*8));
+            break;
+        case OE_FIELD_PRICE_BIN:
+            fieldByte = operationEncode.price.range(((byteIndex*8)+7),(byteIndex*8));
+            break;
+        case OE_FIELD_SYMBOL_BIN:
+            fieldByte = ((0 == byteIndex) ? operationEncode.symbolIndex : ap_uint<8>(0));
+            break;
+        case OE_FIELD_SIDE_BIN:
+            fieldByte = ((ORDER_BID == operationEncode.direction) ? 1 : 2);
+            break;
+        default:
+            break;
+    }
+
+    return fieldByte;
+}
+
+ap_uint<4> OrderEntry::messageFieldLength(ap_uint<8> fieldId)
+{
+#pragma HLS INLINE
+
+    ap_uint<4> fieldLength=0;
+
+    switch(fieldId)
+    {
+        case OE_FIELD_BODY_LENGTH:
+            fieldLength = 3;
+            break;
+        case OE_FIELD_SEQUENCE:
+        case OE_FIELD_ORDER_ID:
+        case OE_FIELD_ORIG_ORDER_ID:
+        case OE_FIELD_QUANTITY:
+            fieldLength = 10;
+            break;
+        case OE_FIELD_SENDING_TIME:
+            fieldLength = 12;
+            break;
+        case OE_FIELD_PRICE:
+            fieldLength = 11;
+            break;
+        case OE_FIELD_SIDE:
+        case OE_FIELD_SIDE_BIN:
+            fieldLength = 1;
+            break;
+        case OE_FIELD_SENDING_DATE:
+        case OE_FIELD_TIMESTAMP_BIN:
+        case OE_FIELD_ORDER_ID_BIN:
+        case OE_FIELD_ORIG_ORDER_ID_BIN:
+        case OE_FIELD_PRICE_BIN:
+            fieldLength = 8;
+            break;
+        case OE_FIELD_SEQUENCE_BIN:
+        case OE_FIELD_QUANTITY_BIN:
+        case OE_FIELD_SYMBOL_BIN:
+            fieldLength = 4;
+            break;
+        default:
+            break;
+    }
+
+    return fieldLength;
+}
+
+ap_uint<1> OrderEntry::messageFieldEncoded(ap_uint<8> fieldId)
+{
+#pragma HLS INLINE
+
+    // fields taken from the ASCII encode stage rather than the operation
+    return (((OE_FIELD_ORDER_ID == fieldId) ||
+             (OE_FIELD_ORIG_ORDER_ID == fieldId) ||
+             (OE_FIELD_QUANTITY == fieldId) ||
+             (OE_FIELD_PRICE == fieldId)) ? 1 : 0);
+}
+
+ap_uint<17> OrderEntry::checksumUpdate(ap_uint<9> byteIndex,
+                                       ap_uint<8> oldByte,
+                                       ap_uint<8> newByte)
+{
+#pragma HLS INLINE
+
+    ap_uint<16> oldWord, newWord;
+
+    // byte at an even offset occupies the upper half of a 16b checksum word
+    if(0 == byteIndex.range(0,0))
+    {
+        oldWord = (oldByte, ap_uint<8>(0));
+        newWord = (newByte, ap_uint<8>(0));
+    }
+    else
+    {
+        oldWord = oldByte;
+        newWord = newByte;
+    }
+
+    // incremental ones' complement update (RFC 1624), replacing word m with
+    // m' adds ~m + m' to the sum, caller folds the carries
+    return ((~oldWord) + ap_uint<17>(newWord));
+}
+
+bool OrderEntry::rxParseFix(orderEntryRxContext_t &context,
+                            ap_uint<8> rxByte,
+                            orderEntryExecReport_t &report)
+{
+#pragma HLS INLINE
+
+    bool reportValid=false;
+    bool delimiter=((0x01 == rxByte) || ('^' == rxByte));
+
+    // tag=value pairs, tags and numeric values are shifted in as BCD digits
+    // so the byte path needs no arithmetic, either SOH or '^' delimits
+    if(!context.inValue)
+    {
+        if('=' == rxByte)
+        {
+            context.inValue = 1;
+            context.value = 0;
+            context.valueChar = 0;
+            context.valueDot = 0;
+            context.valueDecimals = 0;
+        }
+        else if(delimiter)
+        {
+            context.tag = 0;
+        }
+        else
+        {
+            context.tag = ((context.tag << 4) | rxByte.range(3,0));
+        }
+    }
+    else if(delimiter)
+    {
+        switch(context.tag)
+        {
+            case 0x35: // MsgType
+                context.msgType = context.valueChar;
+                break;
+            case 0x11: // ClOrdID
+                context.report.orderId = context.value;
+                break;
+            case 0x150: // ExecType
+                context.report.execType = context.valueChar;
+                break;
+            case 0x32: // LastQty, whole units
+                context.report.quantity = (context.value >> (context.valueDecimals*4));
+                break;
+            case 0x31: // LastPx
+                context.report.price = context.value;
+                context.report.priceDecimals = context.valueDecimals;
+                break;
+            case 0x10: // CheckSum, always the final field
+                reportValid = ('8' == context.msgType);
+                report = context.report;
+                context.msgType = 0;
+                context.report.execType = 0;
+                context.report.orderId = 0;
+                context.report.quantity = 0;
+                context.report.price = 0;
+                context.report.priceDecimals = 0;
+                break;
+            default:
+                break;
+        }
+        context.inValue = 0;
+        context.tag = 0;
+    }
+    else
+    {
+        if(0 == context.valueChar)
+        {
+            context.valueChar = rxByte;
+        }
+
+        // decimal places beyond the internal price precision are dropped
+        if('.' == rxByte)
+        {
+            context.valueDot = 1;
+        }
+        else if(!context.valueDot || (context.valueDecimals < OE_PRICE_DECIMALS))
+        {
+            context.value = ((context.value << 4) | rxByte.range(3,0));
+            if(context.valueDot)
+            {
+                ++context.valueDecimals;
+            }
+        }
+    }
+
+    return reportValid;
+}
+
+bool OrderEntry::rxParseBinary(orderEntryRxContext_t &context,
+                               ap_uint<8> rxByte,
+                               orderEntryExecReport_t &report)
+{
+#pragma HLS INLINE
+
+    bool reportValid=false;
+    ap_uint<16> offset=context.offset;
+
+    // fixed little endian fields located by offset, the framing header
+    // length marks the message boundary
+    if(0 == offset)
+    {
+        context.length.range(7,0) = rxByte;
+    }
+    if(1 == offset)
+    {
+        context.length.range(15,8) = rxByte;
+    }
+    if(6 == offset)
+    {
+        context.templateId.range(7,0) = rxByte;
+    }
+    if(7 == offset)
+    {
+        context.templateId.range(15,8) = rxByte;
+    }
+
+loop_rx_binary_field:
+    for(int i=0; i<5; i++)
+    {
+        if((OE_BIN_EXEC_ORDER_ID + i) == offset)
+        {
+            context.report.orderId.range((i*8)+7,(i*8)) = rxByte;
+        }
+        if((OE_BIN_EXEC_PRICE + i) == offset)
+        {
+            context.report.price.range((i*8)+7,(i*8)) = rxByte;
+        }
+        if(((OE_BIN_EXEC_QUANTITY + i) == offset) && (i < 4))
+        {
+            context.report.quantity.range((i*8)+7,(i*8)) = rxByte;
+        }
+    }
+
+    if(OE_BIN_EXEC_TYPE == offset)
+    {
+        context.report.execType = rxByte;
+    }
+
+    context.offset = (offset + 1);
+    if((offset > 0) && ((offset + 1) >= context.length))
+    {
+        reportValid = ((OE_BIN_EXEC_REPORT == context.templateId) && (context.length > OE_BIN_EXEC_TYPE));
+        context.report.binary = 1;
+        report = context.report;
+        context.offset = 0;
+    }
+
+    return reportValid;
+}
+
+ap_uint<32> OrderEntry::bcdToUint32(ap_uint<40> inputData)
+{
+#pragma HLS INLINE
+
+    ap_uint<40> result=0;
+
+    const ap_uint<30> power[10] = {1, 10, 100, 1000, 10000, 100000, 1000000,
+                                   10000000, 100000000, 1000000000};
+
+loop_bcd_digit:
+    for(int i=0; i<10; i++)
+    {
+        result += (inputData.range((i*4)+3,(i*4)) * power[i]);
+    }
 
-    regTxStatus.range(31,31) = mConnectionStatus.connected;
-    regTxStatus.range(30,29) = mConnectionStatus.error;
-    regTxStatus.range(28,0)  = mConnectionStatus.space;
+    return result.range(31,0);
+}
+
+ap_uint<36> OrderEntry::sendingTimeIncrement(ap_uint<36> time)
+{
+#pragma HLS INLINE
+
+    ap_uint<36> timeNext;
+    ap_uint<4> digit, digitLimit;
+    ap_uint<1> carry=1;
+
+    // limit for each BCD digit from milliseconds up to hours, hour units
+    // wrap at 3 when the hour tens digit is 2 (23:59:59.999 -> 00:00:00.000)
+    const ap_uint<4> limit[9] = {9, 9, 9, 9, 5, 9, 5, 9, 2};
+
+loop_time_digit:
+    for(int i=0; i<9; i++)
+    {
+        digit = time.range(((i*4)+3),(i*4));
+        digitLimit = limit[i];
+
+        if((7 == i) && (2 == time.range(35,32)))
+        {
+            digitLimit = 3;
+        }
+
+        if(carry)
+        {
+            if(digitLimit == digit)
+            {
+                digit = 0;
+            }
+            else
+            {
+                ++digit;
+                carry = 0;
+            }
+        }
+
+        timeNext.range(((i*4)+3),(i*4)) = digit;
+    }
+
+    return timeNext;
+}
+
+void OrderEntry::sendingTimeFormat(sendingTime_t &sendingTime,
+                                   ap_uint<64> &dateAscii,
+                                   ap_uint<96> &timeAscii)
+{
+#pragma HLS INLINE
+
+    // YYYYMMDD
+loop_date_digit:
+    for(int i=0; i<8; i++)
+    {
+        dateAscii.range(((i*8)+7),(i*8)) = (0x30 | sendingTime.date.range(((i*4)+3),(i*4)));
+    }
+
+    // HH:MM:SS.sss
+    timeAscii = (ap_uint<8>(0x30 | sendingTime.time.range(35,32)),
+                 ap_uint<8>(0x30 | sendingTime.time.range(31,28)),
+                 ap_uint<8>(':'),
+                 ap_uint<8>(0x30 | sendingTime.time.range(27,24)),
+                 ap_uint<8>(0x30 | sendingTime.time.range(23,20)),
+                 ap_uint<8>(':'),
+                 ap_uint<8>(0x30 | sendingTime.time.range(19,16)),
+                 ap_uint<8>(0x30 | sendingTime.time.range(15,12)),
+                 ap_uint<8>('.'),
+                 ap_uint<8>(0x30 | sendingTime.time.range(11,8)),
+                 ap_uint<8>(0x30 | sendingTime.time.range(7,4)),
+                 ap_uint<8>(0x30 | sendingTime.time.range(3,0)));
 
     return;
 }
@@ -571,87 +1658,90 @@ ap_uint<64> OrderEntry::byteReverse(ap_uint<64> inputData)
 
 ap_uint<80> OrderEntry::uint32ToAscii(ap_uint<32> inputData)
 {
-#pragma HLS PIPELINE II=1 style=flp
+#pragma HLS INLINE
 
-    ap_uint<40> bcd=0;
-    ap_uint<80> outputAscii("30303030303030303030", 16);
+    ap_uint<17> chunkHigh, chunkLow;
 
-    ap_uint<4> bcdDigit[10]={0,0,0,0,0,0,0,0,0,0};
-    ap_uint<4> bcdNext[10]={0,0,0,0,0,0,0,0,0,0};
-    ap_uint<1> carryIn[10]={0,0,0,0,0,0,0,0,0,0};
-    ap_uint<1> carryOut[10]={0,0,0,0,0,0,0,0,0,0};
+    decimalSplit(inputData, chunkHigh, chunkLow);
 
-#pragma HLS ARRAY_PARTITION variable=bcdDigit complete
-#pragma HLS ARRAY_PARTITION variable=bcdNext complete
-#pragma HLS ARRAY_PARTITION variable=carryIn complete
-#pragma HLS ARRAY_PARTITION variable=carryOut complete
+    return (chunkToAscii(chunkHigh), chunkToAscii(chunkLow));
+}
 
-    // TODO: comment required to explain the algorithm but technique is from
-    //       "XAPP029 - Serial Code Conversion between BCD and Binary"
+ap_uint<160> OrderEntry::uint64ToAscii(ap_uint<64> inputData)
+{
+#pragma HLS INLINE
 
-loop_bcd:
-    for(int i=0; i<32; i++)
-    {
-        carryIn[0] = inputData.range(31-i,31-i);
+    ap_uint<128> product;
+    ap_uint<34> upper, lower;
+    ap_uint<17> chunk[4];
 
-loop_carry:
-        for(int j=1; j<10; j++)
-        {
-            carryIn[j] = carryOut[j-1];
-        }
+#pragma HLS ARRAY_PARTITION variable=chunk complete
 
-loop_digit:
-        for(int j=0; j<10; j++)
-        {
-            bcdDigitiser(carryIn[j], bcdDigit[j], bcdNext[j], carryOut[j]);
-        }
-    }
+    // split into two 10 digit halves, quotient by 10^10 is exact for all
+    // 64b inputs with this reciprocal (2^97/10^10 rounded up)
+    product = (inputData * ap_uint<64>("dbe6fecebdedd5bf", 16));
+    upper = (product >> 97);
+    lower = (inputData - (upper * ap_uint<34>("10000000000", 10)));
 
-loop_ascii:
-    for(int i=0; i<40; i+=4)
-    {
-        outputAscii.range(((i<<1)+3),(i<<1)) = bcdDigit[i>>2];
-    }
+    decimalSplit(upper, chunk[3], chunk[2]);
+    decimalSplit(lower, chunk[1], chunk[0]);
 
-    return outputAscii;
+    return (chunkToAscii(chunk[3]),
+            chunkToAscii(chunk[2]),
+            chunkToAscii(chunk[1]),
+            chunkToAscii(chunk[0]));
 }
 
-void OrderEntry::bcdDigitiser(ap_uint<1> &carryIn,
-                              ap_uint<4> &bcdDigit,
-                              ap_uint<4> &bcdNext,
-                              ap_uint<1> &carryOut)
+ap_uint<88> OrderEntry::priceToAscii(ap_uint<32> inputData)
 {
 #pragma HLS INLINE
 
-    bcdDigit = (bcdNext << 1) | carryIn;
+    ap_uint<17> integer, fraction;
 
-    switch(bcdDigit)
-    {
-        case 5:
-            bcdNext = 0;
-            carryOut = 1;
-            break;
-        case 6:
-            bcdNext = 1;
-            carryOut = 1;
-            break;
-        case 7:
-            bcdNext = 2;
-            carryOut = 1;
-            break;
-        case 8:
-            bcdNext = 3;
-            carryOut = 1;
-            break;
-        case 9:
-            bcdNext = 4;
-            carryOut = 1;
-            break;
-        default:
-            bcdNext = bcdDigit;
-            carryOut = 0;
-    }
+    // prices are fixed point with five decimal places (PRICE_EXPONENT), the
+    // same 10^5 split used for integers yields both parts directly
+    decimalSplit(inputData, integer, fraction);
+
+    return (chunkToAscii(integer), ap_uint<8>('.'), chunkToAscii(fraction));
+}
+
+void OrderEntry::decimalSplit(ap_uint<34> inputData,
+                              ap_uint<17> &quotient,
+                              ap_uint<17> &remainder)
+{
+#pragma HLS INLINE
+
+    ap_uint<68> product;
+
+    // divide by 10^5 using a multiply with the reciprocal (2^50/10^5 rounded
+    // up), exact for all 34b inputs, inputs must be below 10^10 so that the
+    // quotient fits a single five digit chunk
+    product = (inputData * ap_uint<34>("29f16b11d", 16));
+    quotient = (product >> 50);
+    remainder = (inputData - (quotient * 100000));
 
     return;
 }
 
+ap_uint<40> OrderEntry::chunkToAscii(ap_uint<17> inputData)
+{
+#pragma HLS INLINE
+
+    ap_uint<40> outputAscii;
+    ap_uint<34> fraction;
+
+    // scale the chunk to a fixed point value of chunk/10^4 with 30 fraction
+    // bits (2^30/10^4 rounded up), the integer part is then the leading digit
+    // and each multiply by 10 shifts the next digit into the integer part,
+    // the rounding error stays below one digit step for all chunks < 10^5
+    fraction = (inputData * ap_uint<17>(0x1a36f));
+
+loop_chunk_digit:
+    for(int i=0; i<5; i++)
+    {
+        outputAscii.range((39-(i*8)),(32-(i*8))) = (0x30 | fraction.range(33,30));
+        fraction = (fraction.range(29,0) * 10);
+    }
+
+    return outputAscii;
+}
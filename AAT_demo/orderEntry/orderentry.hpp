@@ -22,17 +22,91 @@
 #include "aat_defines.hpp"
 #include "aat_interfaces.hpp"
 
-#define OE_MSG_LEN_BYTES  (256)
-#define OE_MSG_WORD_BYTES (8)
-#define OE_MSG_NUM_FRAME  (OE_MSG_LEN_BYTES/OE_MSG_WORD_BYTES)
+#define OE_MSG_MAX_BYTES    (264)
+#define OE_MSG_WORD_BYTES   (8)
+#define OE_MSG_NUM_FRAME    (OE_MSG_MAX_BYTES/OE_MSG_WORD_BYTES)
+#define OE_MSG_NUM_TEMPLATE (6)
+#define OE_MSG_NUM_FIELD    (12)
+#define OE_MSG_FIELD_BYTES  (12)
+#define OE_MSG_FIX_TRAILER  (7)  // "10=nnn^"
+#define OE_MSG_CAPTURE_BITS (OE_MSG_NUM_FRAME*64)
 
 #define OE_HALT           (1<<0)
 #define OE_RESET_DATA     (1<<1)
 #define OE_RESET_COUNT    (1<<2)
 #define OE_TCP_CONNECT    (1<<3)
 #define OE_TCP_GEN_SUM    (1<<4)
+#define OE_TRACE_ENABLE   (1<<5)
 #define OE_CAPTURE_FREEZE (1<<31)
 
+// number of concurrent egress TCP sessions, power of two
+#define OE_NUM_SESSION    (4)
+
+// operations are queued by class ahead of the message builder, cancels are
+// served first so they are never held behind new orders awaiting credit
+#define OE_CANCEL_QUEUE_DEPTH (16)
+#define OE_ORDER_QUEUE_DEPTH  (64)
+
+// egress trace ring in device memory, one entry per transmitted message of
+// OE_TRACE_ENTRY_WORDS 512b words, a header word followed by the message in
+// wire byte order (first byte in the lowest lane), host reads entries from
+// its head index up to the traceTail status register and writes back head
+#define OE_TRACE_RING_LEN     (4096)
+#define OE_TRACE_ENTRY_WORDS  (8)
+#define OE_TRACE_QUEUE_DEPTH  (4)
+
+// protocol register holds one select bit per session, session 0 in bit 0
+#define OE_PROTOCOL_BINARY (1<<0)
+
+#define OE_TIME_LOAD       (1<<31)
+
+// binary ExecutionReport received from the gateway, same SBE style framing
+// and message header as the egress templates, offsets from message start
+#define OE_BIN_EXEC_REPORT   (8)  // templateId
+#define OE_BIN_EXEC_ORDER_ID (24) // 8B clOrdId
+#define OE_BIN_EXEC_PRICE    (32) // 8B lastPx
+#define OE_BIN_EXEC_QUANTITY (40) // 4B lastQty
+#define OE_BIN_EXEC_TYPE     (48) // 1B execType
+
+// FIX values are accumulated as BCD digits, LastPx is scaled to the
+// internal fixed point price with this many decimal places
+#define OE_PRICE_DECIMALS (5)
+
+// sending time clock prescaler, must match the kernel clock (320MHz)
+#define OE_CLOCK_CYCLES_PER_MS (320000)
+
+enum ORDERENTRY_MESSAGES
+{
+    OE_MSG_NEW_ORDER = 0,       // NewOrderSingle (35=D)
+    OE_MSG_CANCEL_REPLACE,      // OrderCancelReplaceRequest (35=G)
+    OE_MSG_CANCEL,              // OrderCancelRequest (35=F)
+    OE_MSG_BIN_NEW_ORDER,       // binary NewOrder (templateId 1)
+    OE_MSG_BIN_CANCEL_REPLACE,  // binary CancelReplace (templateId 2)
+    OE_MSG_BIN_CANCEL           // binary Cancel (templateId 3)
+};
+
+enum ORDERENTRY_FIELDS
+{
+    OE_FIELD_NONE = 0,
+    OE_FIELD_BODY_LENGTH,       // 3B ASCII
+    OE_FIELD_SEQUENCE,          // 10B ASCII
+    OE_FIELD_SENDING_DATE,      // 8B ASCII, YYYYMMDD
+    OE_FIELD_SENDING_TIME,      // 12B ASCII, HH:MM:SS.sss
+    OE_FIELD_ORDER_ID,          // 10B ASCII
+    OE_FIELD_ORIG_ORDER_ID,     // 10B ASCII
+    OE_FIELD_QUANTITY,          // 10B ASCII
+    OE_FIELD_PRICE,             // 11B ASCII, fixed point
+    OE_FIELD_SIDE,              // 1B ASCII
+    OE_FIELD_SEQUENCE_BIN,      // 4B little endian
+    OE_FIELD_TIMESTAMP_BIN,     // 8B little endian
+    OE_FIELD_ORDER_ID_BIN,      // 8B little endian
+    OE_FIELD_ORIG_ORDER_ID_BIN, // 8B little endian
+    OE_FIELD_QUANTITY_BIN,      // 4B little endian
+    OE_FIELD_PRICE_BIN,         // 8B little endian
+    OE_FIELD_SYMBOL_BIN,        // 4B little endian
+    OE_FIELD_SIDE_BIN           // 1B
+};
+
 typedef struct orderEntryRegControl_t
 {
     ap_uint<32> control;
@@ -40,9 +114,9 @@ typedef struct orderEntryRegControl_t
     ap_uint<32> capture;
     ap_uint<32> destAddress;
     ap_uint<32> destPort;
-    ap_uint<32> reserved05;
-    ap_uint<32> reserved06;
-    ap_uint<32> reserved07;
+    ap_uint<32> protocol;
+    ap_uint<32> sendingDate;
+    ap_uint<32> sendingTime;
 } orderEntryRegControl_t;
 
 typedef struct orderEntryRegStatus_t
@@ -61,10 +135,34 @@ typedef struct orderEntryRegStatus_t
     ap_uint<32> notification;
     ap_uint<32> readRequest;
     ap_uint<32> debug;
-    ap_uint<32> reserved14;
-    ap_uint<32> reserved15;
+    ap_uint<32> sessionConnected;
+    ap_uint<32> rxFill;
+    ap_uint<32> txStall;
+    ap_uint<32> traceTail;
+    ap_uint<32> traceDrop;
 } orderEntryRegStatus_t;
 
+// container wrapping session table used in order to apply ARRAY_PARTITION
+// pragma for top level interface in vitis_hls, sessions 1 and above take
+// their gateway destination from this table while session 0 remains on the
+// destAddress/destPort control registers, a zero port leaves the session
+// unused, route maps each symbolIndex to the session its orders are sent on
+typedef struct orderEntryRegSessionContainer
+{
+    ap_uint<32> destAddress[OE_NUM_SESSION];
+    ap_uint<32> destPort[OE_NUM_SESSION];
+    ap_uint<32> route[NUM_SYMBOL];
+
+    orderEntryRegSessionContainer()
+    {
+#pragma HLS INLINE
+#pragma HLS ARRAY_PARTITION variable=destAddress complete
+#pragma HLS ARRAY_PARTITION variable=destPort complete
+#pragma HLS ARRAY_PARTITION variable=route complete
+    }
+
+} orderEntryRegSessionContainer_t;
+
 typedef struct connectionStatus_t
 {
     ap_uint<1> connected;
@@ -72,8 +170,155 @@ typedef struct connectionStatus_t
     ap_uint<30> space;
     ap_uint<2> error;
     ap_uint<16> sessionID;
+    ap_uint<32> acked; // bytes reported by transmit status since connect
 } connectionStatus_t;
 
+// TCP session ID held by a session slot, sent from the connection process to
+// the receive process on connect and disconnect so the receive side keeps its
+// own copy of the map rather than reading the connection status member
+typedef struct orderEntrySessionMap_t
+{
+    ap_uint<8>  session;
+    ap_uint<16> sessionID;
+    ap_uint<1>  connected;
+} orderEntrySessionMap_t;
+
+typedef struct sendingTime_t
+{
+    ap_uint<32> date; // BCD YYYYMMDD
+    ap_uint<36> time; // BCD HHMMSSsss
+} sendingTime_t;
+
+typedef struct orderEntryField_t
+{
+    ap_uint<8> id;
+    ap_uint<9> offset;
+} orderEntryField_t;
+
+// execution report fields as captured from the receive stream, FIX values
+// are held as BCD digits and converted in a later stage, binary values are
+// captured in their little endian wire form
+typedef struct orderEntryExecReport_t
+{
+    ap_uint<1>  binary;
+    ap_uint<8>  execType;
+    ap_uint<40> orderId;
+    ap_uint<40> quantity;
+    ap_uint<40> price;
+    ap_uint<3>  priceDecimals;
+} orderEntryExecReport_t;
+
+// receive parser state, held per session as TCP segments from different
+// sessions may interleave part way through a message
+typedef struct orderEntryRxContext_t
+{
+    ap_uint<1>  inValue;       // FIX, scanning value rather than tag
+    ap_uint<20> tag;           // FIX, BCD tag number
+    ap_uint<40> value;         // FIX, BCD value digits
+    ap_uint<8>  valueChar;     // FIX, first value character
+    ap_uint<1>  valueDot;      // FIX, decimal point seen in value
+    ap_uint<3>  valueDecimals; // FIX, digits after decimal point
+    ap_uint<8>  msgType;       // FIX, MsgType (35)
+    ap_uint<16> offset;        // binary, byte offset within message
+    ap_uint<16> length;        // binary, framing header message length
+    ap_uint<16> templateId;    // binary, message header templateId
+    orderEntryExecReport_t report;
+} orderEntryRxContext_t;
+
+// egress trace entry, header word layout in the ring is
+//   [63:0] txTimestamp, [127:64] timestamp, [143:128] sessionID,
+//   [151:144] session, [167:152] length, [199:168] sequence,
+//   [207:200] opCode, [215:208] symbolIndex
+typedef struct orderEntryTraceEntry_t
+{
+    ap_uint<64> txTimestamp; // kernel cycle count at first frame sent
+    ap_uint<64> timestamp;   // operation timestamp
+    ap_uint<16> sessionID;   // TCP session ID
+    ap_uint<8>  session;
+    ap_uint<16> length;
+    ap_uint<32> sequence;
+    ap_uint<8>  opCode;
+    ap_uint<8>  symbolIndex;
+    ap_uint<OE_MSG_CAPTURE_BITS> message;
+} orderEntryTraceEntry_t;
+
+// session level values applied to the message alongside the operation
+typedef struct orderEntryMessageHeader_t
+{
+    ap_uint<32> sequence;
+    ap_uint<80> sequenceAscii;
+    ap_uint<24> bodyLength;
+    ap_uint<64> sendingDate;
+    ap_uint<96> sendingTime;
+} orderEntryMessageHeader_t;
+
+// ones' complement sum of a message in 16b network order words, the byte at
+// an even offset is the upper half of a word, a trailing odd byte is padded
+constexpr unsigned short orderEntryTemplateSum(const unsigned char *message,
+                                               unsigned short length)
+{
+    unsigned int sum=0;
+
+    for(unsigned short i=0; i<length; i++)
+    {
+        sum += ((i & 1) ? message[i] : (message[i] << 8));
+    }
+
+    while(sum >> 16)
+    {
+        sum = ((sum & 0xFFFF) + (sum >> 16));
+    }
+
+    return sum;
+}
+
+// sum of the bytes preceding the FIX trailer, the message checksum (tag 10)
+// is this sum modulo 256 once the dynamic fields have been applied
+constexpr unsigned char orderEntryTemplateByteSum(const unsigned char *message,
+                                                  unsigned short length)
+{
+    unsigned int sum=0;
+
+    for(unsigned short i=0; i<(length-OE_MSG_FIX_TRAILER); i++)
+    {
+        sum += message[i];
+    }
+
+    return (sum & 0xFF);
+}
+
+// FIX body length (tag 9) counts from the field following BodyLength up to
+// and including the delimiter preceding the trailer, fields are fixed width
+// so the body length is constant for each template
+constexpr unsigned short orderEntryTemplateBodyLength(const unsigned char *message,
+                                                      unsigned short length)
+{
+    unsigned short delimiter=0, start=0;
+
+    while(delimiter < 2)
+    {
+        if('^' == message[start++])
+        {
+            ++delimiter;
+        }
+    }
+
+    return ((length - OE_MSG_FIX_TRAILER) - start);
+}
+
+// length of an ASCII template, used to check the FIX template lengths
+constexpr unsigned short orderEntryTemplateLength(const unsigned char *message)
+{
+    unsigned short length=0;
+
+    while(message[length] != 0)
+    {
+        ++length;
+    }
+
+    return length;
+}
+
 /**
  * OrderEntry Core
  */
@@ -81,13 +326,33 @@ class OrderEntry
 {
 public:
 
-    void operationPull(ap_uint<32> &regRxOperation,
+    OrderEntry()
+    {
+#pragma HLS INLINE
+        // message is assembled in a single cycle, all template bytes and
+        // field descriptors of the selected template are read in parallel
+#pragma HLS ARRAY_PARTITION variable=messageTemplate complete dim=2
+#pragma HLS ARRAY_PARTITION variable=messageField complete dim=2
+#pragma HLS ARRAY_PARTITION variable=mConnectionStatus complete
+    }
+
+    void sendingTimeClock(ap_uint<32> &regSendingDate,
+                          ap_uint<32> &regSendingTime);
+
+    void operationPull(ap_uint<32> &regProtocol,
+                       ap_uint<32> &regRxOperation,
+                       ap_uint<32> regSessionRoute[NUM_SYMBOL],
                        hls::stream<orderEntryOperationPack_t> &operationStreamPack,
                        hls::stream<orderEntryOperationPack_t> &operationHostStreamPack,
-                       hls::stream<orderEntryOperation_t> &operationStream);
+                       hls::stream<orderEntryOperationEncode_t> &operationStream,
+                       hls::stream<orderEntryOperationEncode_t> &operationCancelStream,
+                       hls::stream<orderEntryOperationEncode_t> &operationTxStream,
+                       hls::stream<orderEntryOperationEncode_t> &operationTxCancelStream);
 
-    void operationEncode(hls::stream<orderEntryOperation_t> &operationStream,
-                         hls::stream<orderEntryOperationEncode_t> &operationEncodeStream);
+    void operationEncode(hls::stream<orderEntryOperationEncode_t> &operationStream,
+                         hls::stream<orderEntryOperationEncode_t> &operationCancelStream,
+                         hls::stream<orderEntryOperationEncode_t> &operationEncodeStream,
+                         hls::stream<orderEntryOperationEncode_t> &operationEncodeCancelStream);
 
     void openListenPortTcp(hls::stream<ipTcpListenPortPack_t> &listenPortStream,
                            hls::stream<ipTcpListenStatusPack_t> &listenStatusStream);
@@ -96,20 +361,31 @@ public:
                            ap_uint<32> &regDestAddress,
                            ap_uint<32> &regDestPort,
                            ap_uint<32> &regDebug,
+                           ap_uint<32> &regSessionConnected,
+                           ap_uint<32> regSessionDestAddress[OE_NUM_SESSION],
+                           ap_uint<32> regSessionDestPort[OE_NUM_SESSION],
                            hls::stream<ipTuplePack_t> &openConnectionStream,
                            hls::stream<ipTcpConnectionStatusPack_t> &connectionStatusStream,
                            hls::stream<ipTcpCloseConnectionPack_t> &closeConnectionStream,
-                           hls::stream<ipTcpTxStatusPack_t> &txStatusStream);
+                           hls::stream<ipTcpTxStatusPack_t> &txStatusStream,
+                           hls::stream<orderEntrySessionMap_t> &sessionMapStream);
 
     void notificationHandlerTcp(ap_uint<32> &regNotification,
                                 ap_uint<32> &regReadRequest,
                                 hls::stream<ipTcpNotificationPack_t> &notificationStream,
                                 hls::stream<ipTcpReadRequestPack_t> &readRequestStream);
 
-    void serverProcessTcp(ap_uint<32> &regRxData,
+    void serverProcessTcp(ap_uint<32> &regProtocol,
+                          ap_uint<32> &regRxData,
                           ap_uint<32> &regRxMeta,
                           hls::stream<ipTcpRxMetaPack_t> &rxMetaStream,
-                          hls::stream<ipTcpRxDataPack_t> &rxDataStream);
+                          hls::stream<ipTcpRxDataPack_t> &rxDataStream,
+                          hls::stream<orderEntrySessionMap_t> &sessionMapStream,
+                          hls::stream<orderEntryExecReport_t> &execReportStream);
+
+    void executionReportDecode(ap_uint<32> &regRxFill,
+                               hls::stream<orderEntryExecReport_t> &execReportStream,
+                               hls::stream<orderEntryFillPack_t> &fillStream);
 
     void operationProcessTcp(ap_uint<32> &regControl,
                              ap_uint<32> &regCaptureControl,
@@ -119,66 +395,254 @@ public:
                              ap_uint<32> &regTxMeta,
                              ap_uint<32> &regTxStatus,
                              ap_uint<32> &regTxDrop,
-                             ap_uint<1024> &regCaptureBuffer,
+                             ap_uint<32> &regTxStall,
+                             ap_uint<32> &regTraceDrop,
+                             ap_uint<OE_MSG_CAPTURE_BITS> &regCaptureBuffer,
+                             hls::stream<orderEntryOperationEncode_t> &operationTxStream,
+                             hls::stream<orderEntryOperationEncode_t> &operationTxCancelStream,
                              hls::stream<orderEntryOperationEncode_t> &operationEncodeStream,
+                             hls::stream<orderEntryOperationEncode_t> &operationEncodeCancelStream,
                              hls::stream<ipTcpTxMetaPack_t> &txMetaStream,
-                             hls::stream<ipTcpTxDataPack_t> &txDataStream);
+                             hls::stream<ipTcpTxDataPack_t> &txDataStream,
+                             hls::stream<orderEntryTraceEntry_t> &traceStream);
+
+    void messageTrace(ap_uint<32> &regTraceHead,
+                      ap_uint<32> &regTraceTail,
+                      ap_uint<512> traceRing[OE_TRACE_RING_LEN*OE_TRACE_ENTRY_WORDS],
+                      hls::stream<orderEntryTraceEntry_t> &traceStream);
+
+    // binary to ASCII conversion, zero padded to the full field width
+    ap_uint<80> uint32ToAscii(ap_uint<32> inputData);
+
+    ap_uint<160> uint64ToAscii(ap_uint<64> inputData);
 
+    ap_uint<88> priceToAscii(ap_uint<32> inputData);
 
 private:
 
-    connectionStatus_t mConnectionStatus;
+    connectionStatus_t mConnectionStatus[OE_NUM_SESSION];
 
-    // we store a template for the egress message here and populate the dynamic
-    // fields such as price and quantity before we transmit, the partial sum
-    // for the template message is pre-computed, a potential improvement for
-    // reduced manual maintenance would be to calculate at compile time
-    ap_uint<16> messageTemplateSum = 0x1b65;
+    sendingTime_t mSendingTime;
 
-    ap_uint<64> messageTemplate[OE_MSG_NUM_FRAME] =
+    // egress messages are assembled from a per opCode template, the dynamic
+    // fields such as price and quantity are overwritten at the byte offsets
+    // listed in the field descriptors before we transmit, placeholders are
+    // fixed width so each message type has a constant length, '^' is used
+    // as the field delimiter for readability in captures
+    static constexpr unsigned short messageTemplateLength[OE_MSG_NUM_TEMPLATE] = {247, 261, 207, 51, 59, 45};
+
+    // binary templates follow an SBE style layout, little endian fixed
+    // fields behind a 4B framing header (length, 0xCAFE encoding type) and
+    // an 8B message header (blockLength, templateId, schemaId, version)
+    static constexpr unsigned char messageTemplate[OE_MSG_NUM_TEMPLATE][OE_MSG_MAX_BYTES] =
     {
-        0x383d4649582e342e,
-        0x325e393d3133355e,
-        0x33353d445e33343d,
-        0x0000000000000000, // sequence (MSB)
-        0x00005e34393d4142, // sequence (LSB)
-        0x433132334e5e3530,
-        0x3d58465f46494e54,
-        0x4543485e35323d32,
-        0x303139303832382d,
-        0x0000000000000000, // timestamp
-        0x5e35363d434d455e,
-        0x35373d475e313432,
-        0x3d49455e5e33353d,
-        0x445e313d584c4e58,
-        0x3132333435363738,
-        0x5e31313d00000000, // orderId (MSB)
-        0x0000000000005e33, // orderId (LSB)
-        0x383d000000000000, // quantity (MSB)
-        0x000000005e34303d, // quantity (LSB)
-        0x325e34343d000000, // price (MSB)
-        0x000000000000005e, // price (LSB)
-        0x35343d315e35353d,
-        0x584c4e585e36303d,
-        0x3230313930383238,
-        0x2d31303a31313a31,
-        0x325e313032383d4e,
-        0x5e3130373d43455a,
-        0x392043393337355e,
-        0x3230343d305e3937,
-        0x30323d315e5e3130,
-        0x3d43484b2e2e2e2e,
-        0x2e2e2e2e2e2e2e2e,
+        "8=FIX.4.2^9=000^35=D^34=0000000000^49=ABC123N^50=XF_FINTECH^52=00000000-00:00:00.000^56=CME^57=G^142=IE^"
+        "1=XLNX12345678^11=0000000000^38=0000000000^40=2^44=00000.00000^54=1^55=XLNX^60=00000000-00:00:00.000^"
+        "107=CEZ9 C9375^204=0^1028=N^9702=1^10=000^",
+
+        "8=FIX.4.2^9=000^35=G^34=0000000000^49=ABC123N^50=XF_FINTECH^52=00000000-00:00:00.000^56=CME^57=G^142=IE^"
+        "1=XLNX12345678^11=0000000000^41=0000000000^38=0000000000^40=2^44=00000.00000^54=1^55=XLNX^"
+        "60=00000000-00:00:00.000^107=CEZ9 C9375^204=0^1028=N^9702=1^10=000^",
+
+        "8=FIX.4.2^9=000^35=F^34=0000000000^49=ABC123N^50=XF_FINTECH^52=00000000-00:00:00.000^56=CME^57=G^142=IE^"
+        "1=XLNX12345678^11=0000000000^41=0000000000^54=1^55=XLNX^60=00000000-00:00:00.000^107=CEZ9 C9375^10=000^",
+
+        {
+            0x33, 0x00, 0xfe, 0xca, 0x27, 0x00, 0x01, 0x00, // header
+            0x01, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, // header, seqNum
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // sendingTime
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // clOrdId
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // price
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // orderQty, securityId
+            0x00, 0x02, 0x00,                               // side, ordType (limit), timeInForce (day)
+        },
+
+        {
+            0x3b, 0x00, 0xfe, 0xca, 0x2f, 0x00, 0x02, 0x00, // header
+            0x01, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, // header, seqNum
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // sendingTime
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // clOrdId
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // origClOrdId
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // price
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // orderQty, securityId
+            0x00, 0x02, 0x00,                               // side, ordType (limit), timeInForce (day)
+        },
+
+        {
+            0x2d, 0x00, 0xfe, 0xca, 0x21, 0x00, 0x03, 0x00, // header
+            0x01, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, // header, seqNum
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // sendingTime
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // clOrdId
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // origClOrdId
+            0x00, 0x00, 0x00, 0x00, 0x00,                   // securityId, side
+        },
     };
 
+    // partial sum for each template including placeholder bytes, generated
+    // at compile time so templates may be edited without manual maintenance
+    static constexpr unsigned short messageTemplateSum[OE_MSG_NUM_TEMPLATE] =
+    {
+        orderEntryTemplateSum(messageTemplate[OE_MSG_NEW_ORDER], messageTemplateLength[OE_MSG_NEW_ORDER]),
+        orderEntryTemplateSum(messageTemplate[OE_MSG_CANCEL_REPLACE], messageTemplateLength[OE_MSG_CANCEL_REPLACE]),
+        orderEntryTemplateSum(messageTemplate[OE_MSG_CANCEL], messageTemplateLength[OE_MSG_CANCEL]),
+        orderEntryTemplateSum(messageTemplate[OE_MSG_BIN_NEW_ORDER], messageTemplateLength[OE_MSG_BIN_NEW_ORDER]),
+        orderEntryTemplateSum(messageTemplate[OE_MSG_BIN_CANCEL_REPLACE], messageTemplateLength[OE_MSG_BIN_CANCEL_REPLACE]),
+        orderEntryTemplateSum(messageTemplate[OE_MSG_BIN_CANCEL], messageTemplateLength[OE_MSG_BIN_CANCEL]),
+    };
+
+    // FIX body length and checksum over the static template bytes, the
+    // checksum is completed at run time with the dynamic field updates
+    static constexpr unsigned short messageBodyLength[OE_MSG_NUM_TEMPLATE] =
+    {
+        orderEntryTemplateBodyLength(messageTemplate[OE_MSG_NEW_ORDER], messageTemplateLength[OE_MSG_NEW_ORDER]),
+        orderEntryTemplateBodyLength(messageTemplate[OE_MSG_CANCEL_REPLACE], messageTemplateLength[OE_MSG_CANCEL_REPLACE]),
+        orderEntryTemplateBodyLength(messageTemplate[OE_MSG_CANCEL], messageTemplateLength[OE_MSG_CANCEL]),
+        0, 0, 0,
+    };
+
+    static constexpr unsigned char messageTemplateByteSum[OE_MSG_NUM_TEMPLATE] =
+    {
+        orderEntryTemplateByteSum(messageTemplate[OE_MSG_NEW_ORDER], messageTemplateLength[OE_MSG_NEW_ORDER]),
+        orderEntryTemplateByteSum(messageTemplate[OE_MSG_CANCEL_REPLACE], messageTemplateLength[OE_MSG_CANCEL_REPLACE]),
+        orderEntryTemplateByteSum(messageTemplate[OE_MSG_CANCEL], messageTemplateLength[OE_MSG_CANCEL]),
+        0, 0, 0,
+    };
+
+    static_assert(orderEntryTemplateLength(messageTemplate[OE_MSG_NEW_ORDER]) == messageTemplateLength[OE_MSG_NEW_ORDER],
+                  "NewOrderSingle template length mismatch");
+    static_assert(orderEntryTemplateLength(messageTemplate[OE_MSG_CANCEL_REPLACE]) == messageTemplateLength[OE_MSG_CANCEL_REPLACE],
+                  "OrderCancelReplaceRequest template length mismatch");
+    static_assert(orderEntryTemplateLength(messageTemplate[OE_MSG_CANCEL]) == messageTemplateLength[OE_MSG_CANCEL],
+                  "OrderCancelRequest template length mismatch");
+
+    // field descriptors (id, byte offset), ClOrdID (11) is the fresh orderId
+    // PricingEngine issues for every request and OrigClOrdID (41) the order
+    // being replaced or cancelled, SendingTime (52) and TransactTime (60) are
+    // both taken from the clock
+    const orderEntryField_t messageField[OE_MSG_NUM_TEMPLATE][OE_MSG_NUM_FIELD] =
+    {
+        {
+            {OE_FIELD_BODY_LENGTH, 12},
+            {OE_FIELD_SEQUENCE, 24},
+            {OE_FIELD_SENDING_DATE, 63},
+            {OE_FIELD_SENDING_TIME, 72},
+            {OE_FIELD_ORDER_ID, 122},
+            {OE_FIELD_QUANTITY, 136},
+            {OE_FIELD_PRICE, 155},
+            {OE_FIELD_SIDE, 170},
+            {OE_FIELD_SENDING_DATE, 183},
+            {OE_FIELD_SENDING_TIME, 192},
+            {OE_FIELD_NONE, 0},
+            {OE_FIELD_NONE, 0},
+        },
+        {
+            {OE_FIELD_BODY_LENGTH, 12},
+            {OE_FIELD_SEQUENCE, 24},
+            {OE_FIELD_SENDING_DATE, 63},
+            {OE_FIELD_SENDING_TIME, 72},
+            {OE_FIELD_ORDER_ID, 122},
+            {OE_FIELD_ORIG_ORDER_ID, 136},
+            {OE_FIELD_QUANTITY, 150},
+            {OE_FIELD_PRICE, 169},
+            {OE_FIELD_SIDE, 184},
+            {OE_FIELD_SENDING_DATE, 197},
+            {OE_FIELD_SENDING_TIME, 206},
+            {OE_FIELD_NONE, 0},
+        },
+        {
+            {OE_FIELD_BODY_LENGTH, 12},
+            {OE_FIELD_SEQUENCE, 24},
+            {OE_FIELD_SENDING_DATE, 63},
+            {OE_FIELD_SENDING_TIME, 72},
+            {OE_FIELD_ORDER_ID, 122},
+            {OE_FIELD_ORIG_ORDER_ID, 136},
+            {OE_FIELD_SIDE, 150},
+            {OE_FIELD_SENDING_DATE, 163},
+            {OE_FIELD_SENDING_TIME, 172},
+            {OE_FIELD_NONE, 0},
+            {OE_FIELD_NONE, 0},
+            {OE_FIELD_NONE, 0},
+        },
+        {
+            {OE_FIELD_SEQUENCE_BIN, 12},
+            {OE_FIELD_TIMESTAMP_BIN, 16},
+            {OE_FIELD_ORDER_ID_BIN, 24},
+            {OE_FIELD_PRICE_BIN, 32},
+            {OE_FIELD_QUANTITY_BIN, 40},
+            {OE_FIELD_SYMBOL_BIN, 44},
+            {OE_FIELD_SIDE_BIN, 48},
+            {OE_FIELD_NONE, 0},
+            {OE_FIELD_NONE, 0},
+            {OE_FIELD_NONE, 0},
+            {OE_FIELD_NONE, 0},
+            {OE_FIELD_NONE, 0},
+        },
+        {
+            {OE_FIELD_SEQUENCE_BIN, 12},
+            {OE_FIELD_TIMESTAMP_BIN, 16},
+            {OE_FIELD_ORDER_ID_BIN, 24},
+            {OE_FIELD_ORIG_ORDER_ID_BIN, 32},
+            {OE_FIELD_PRICE_BIN, 40},
+            {OE_FIELD_QUANTITY_BIN, 48},
+            {OE_FIELD_SYMBOL_BIN, 52},
+            {OE_FIELD_SIDE_BIN, 56},
+            {OE_FIELD_NONE, 0},
+            {OE_FIELD_NONE, 0},
+            {OE_FIELD_NONE, 0},
+            {OE_FIELD_NONE, 0},
+        },
+        {
+            {OE_FIELD_SEQUENCE_BIN, 12},
+            {OE_FIELD_TIMESTAMP_BIN, 16},
+            {OE_FIELD_ORDER_ID_BIN, 24},
+            {OE_FIELD_ORIG_ORDER_ID_BIN, 32},
+            {OE_FIELD_SYMBOL_BIN, 40},
+            {OE_FIELD_SIDE_BIN, 44},
+            {OE_FIELD_NONE, 0},
+            {OE_FIELD_NONE, 0},
+            {OE_FIELD_NONE, 0},
+            {OE_FIELD_NONE, 0},
+            {OE_FIELD_NONE, 0},
+            {OE_FIELD_NONE, 0},
+        },
+    };
+
+    ap_uint<8> messageFieldByte(orderEntryOperationEncode_t &operationEncode,
+                                orderEntryMessageHeader_t &messageHeader,
+                                ap_uint<8> fieldId,
+                                ap_uint<4> byteIndex);
+
+    ap_uint<4> messageFieldLength(ap_uint<8> fieldId);
+
+    ap_uint<1> messageFieldEncoded(ap_uint<8> fieldId);
+
+    ap_uint<17> checksumUpdate(ap_uint<9> byteIndex,
+                               ap_uint<8> oldByte,
+                               ap_uint<8> newByte);
+
+    bool rxParseFix(orderEntryRxContext_t &context,
+                    ap_uint<8> rxByte,
+                    orderEntryExecReport_t &report);
+
+    bool rxParseBinary(orderEntryRxContext_t &context,
+                       ap_uint<8> rxByte,
+                       orderEntryExecReport_t &report);
+
+    ap_uint<32> bcdToUint32(ap_uint<40> inputData);
+
+    ap_uint<36> sendingTimeIncrement(ap_uint<36> time);
+
+    void sendingTimeFormat(sendingTime_t &sendingTime,
+                           ap_uint<64> &dateAscii,
+                           ap_uint<96> &timeAscii);
+
     ap_uint<64> byteReverse(ap_uint<64> inputData);
 
-    ap_uint<80> uint32ToAscii(ap_uint<32> inputData);
+    void decimalSplit(ap_uint<34> inputData,
+                      ap_uint<17> &quotient,
+                      ap_uint<17> &remainder);
 
-    void bcdDigitiser(ap_uint<1> &carryIn,
-                      ap_uint<4> &bcdDigit,
-                      ap_uint<4> &bcdNext,
-                      ap_uint<1> &carryOut);
+    ap_uint<40> chunkToAscii(ap_uint<17> inputData);
 
 };
 
@@ -21,7 +21,10 @@
 
 extern "C" void orderEntryTcpTop(orderEntryRegControl_t &regControl,
                                  orderEntryRegStatus_t &regStatus,
-                                 ap_uint<1024> &regCapture,
+                                 ap_uint<OE_MSG_CAPTURE_BITS> &regCapture,
+                                 orderEntryRegSessionContainer_t &regSession,
+                                 ap_uint<32> &regTraceHead,
+                                 ap_uint<512> *traceRing,
                                  hls::stream<orderEntryOperationPack_t> &operationStreamPack,
                                  hls::stream<orderEntryOperationPack_t> &operationHostStreamPack,
                                  hls::stream<ipTcpListenPortPack_t> &listenPortStreamPack,
@@ -35,6 +38,7 @@ extern "C" void orderEntryTcpTop(orderEntryRegControl_t &regControl,
                                  hls::stream<ipTcpCloseConnectionPack_t> &closeConnectionStreamPack,
                                  hls::stream<ipTcpTxMetaPack_t> &txMetaStreamPack,
                                  hls::stream<ipTcpTxDataPack_t> &txDataStreamPack,
-                                 hls::stream<ipTcpTxStatusPack_t> &txStatusStreamPack);
+                                 hls::stream<ipTcpTxStatusPack_t> &txStatusStreamPack,
+                                 hls::stream<orderEntryFillPack_t> &fillStreamPack);
 
 #endif
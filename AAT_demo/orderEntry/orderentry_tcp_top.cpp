@@ -18,7 +18,10 @@
 
 extern "C" void orderEntryTcpTop(orderEntryRegControl_t &regControl,
                                  orderEntryRegStatus_t &regStatus,
-                                 ap_uint<1024> &regCapture,
+                                 ap_uint<OE_MSG_CAPTURE_BITS> &regCapture,
+                                 orderEntryRegSessionContainer_t &regSession,
+                                 ap_uint<32> &regTraceHead,
+                                 ap_uint<512> *traceRing,
                                  hls::stream<orderEntryOperationPack_t> &operationStreamPack,
                                  hls::stream<orderEntryOperationPack_t> &operationHostStreamPack,
                                  hls::stream<ipTcpListenPortPack_t> &listenPortStreamPack,
@@ -32,14 +35,20 @@ extern "C" void orderEntryTcpTop(orderEntryRegControl_t &regControl,
                                  hls::stream<ipTcpCloseConnectionPack_t> &closeConnectionStreamPack,
                                  hls::stream<ipTcpTxMetaPack_t> &txMetaStreamPack,
                                  hls::stream<ipTcpTxDataPack_t> &txDataStreamPack,
-                                 hls::stream<ipTcpTxStatusPack_t> &txStatusStreamPack)
+                                 hls::stream<ipTcpTxStatusPack_t> &txStatusStreamPack,
+                                 hls::stream<orderEntryFillPack_t> &fillStreamPack)
 {
 #pragma HLS INTERFACE s_axilite port=regControl bundle=control
 #pragma HLS INTERFACE s_axilite port=regStatus bundle=control
 #pragma HLS INTERFACE s_axilite port=regCapture bundle=control
+#pragma HLS INTERFACE s_axilite port=regSession bundle=control
+#pragma HLS INTERFACE s_axilite port=regTraceHead bundle=control
+#pragma HLS INTERFACE m_axi port=traceRing offset=slave
 #pragma HLS INTERFACE ap_none port=regControl
 #pragma HLS INTERFACE ap_none port=regStatus
 #pragma HLS INTERFACE ap_none port=regCapture
+#pragma HLS INTERFACE ap_none port=regSession
+#pragma HLS INTERFACE ap_none port=regTraceHead
 #pragma HLS INTERFACE axis register port=operationStreamPack
 #pragma HLS INTERFACE axis register port=operationHostStreamPack
 #pragma HLS INTERFACE axis register port=listenPortStreamPack
@@ -54,17 +63,38 @@ extern "C" void orderEntryTcpTop(orderEntryRegControl_t &regControl,
 #pragma HLS INTERFACE axis register port=txMetaStreamPack depth=32
 #pragma HLS INTERFACE axis register port=txDataStreamPack depth=32
 #pragma HLS INTERFACE axis register port=txStatusStreamPack
+#pragma HLS INTERFACE axis register port=fillStreamPack
 #pragma HLS INTERFACE ap_ctrl_none port=return
 
-    static hls::stream<orderEntryOperation_t> operationStreamFIFO;
+    static hls::stream<orderEntryOperationEncode_t> operationStreamFIFO;
+    static hls::stream<orderEntryOperationEncode_t> operationCancelStreamFIFO;
     static hls::stream<orderEntryOperationEncode_t> operationEncodeStreamFIFO;
+    static hls::stream<orderEntryOperationEncode_t> operationEncodeCancelStreamFIFO;
+    static hls::stream<orderEntryOperationEncode_t> operationTxStreamFIFO;
+    static hls::stream<orderEntryOperationEncode_t> operationTxCancelStreamFIFO;
     static hls::stream<ipTcpTxStatus_t> txStatusStreamFIFO;
+    static hls::stream<orderEntryExecReport_t> execReportStreamFIFO;
+    static hls::stream<orderEntryTraceEntry_t> traceStreamFIFO;
+    static hls::stream<orderEntrySessionMap_t> sessionMapStreamFIFO;
     static OrderEntry kernel;
 
+#pragma HLS STREAM variable=operationStreamFIFO depth=OE_ORDER_QUEUE_DEPTH
+#pragma HLS STREAM variable=operationCancelStreamFIFO depth=OE_CANCEL_QUEUE_DEPTH
+#pragma HLS STREAM variable=operationEncodeStreamFIFO depth=OE_ORDER_QUEUE_DEPTH
+#pragma HLS STREAM variable=operationEncodeCancelStreamFIFO depth=OE_CANCEL_QUEUE_DEPTH
+#pragma HLS STREAM variable=operationTxStreamFIFO depth=OE_ORDER_QUEUE_DEPTH
+#pragma HLS STREAM variable=operationTxCancelStreamFIFO depth=OE_CANCEL_QUEUE_DEPTH
+#pragma HLS STREAM variable=traceStreamFIFO depth=OE_TRACE_QUEUE_DEPTH
+#pragma HLS STREAM variable=sessionMapStreamFIFO depth=OE_NUM_SESSION
+
 #pragma HLS DISAGGREGATE variable=regControl
 #pragma HLS DISAGGREGATE variable=regStatus
+#pragma HLS STABLE variable=regSession
 #pragma HLS DATAFLOW disable_start_propagation
 
+    kernel.sendingTimeClock(regControl.sendingDate,
+                            regControl.sendingTime);
+
     kernel.openListenPortTcp(listenPortStreamPack,
                              listenStatusStreamPack);
 
@@ -72,18 +102,29 @@ extern "C" void orderEntryTcpTop(orderEntryRegControl_t &regControl,
                              regControl.destAddress,
                              regControl.destPort,
                              regStatus.debug,
+                             regStatus.sessionConnected,
+                             regSession.destAddress,
+                             regSession.destPort,
                              openConnectionStreamPack,
                              connectionStatusStreamPack,
                              closeConnectionStreamPack,
-                             txStatusStreamPack);
+                             txStatusStreamPack,
+                             sessionMapStreamFIFO);
 
-    kernel.operationPull(regStatus.rxOperation,
+    kernel.operationPull(regControl.protocol,
+                         regStatus.rxOperation,
+                         regSession.route,
                          operationStreamPack,
                          operationHostStreamPack,
-                         operationStreamFIFO);
+                         operationStreamFIFO,
+                         operationCancelStreamFIFO,
+                         operationTxStreamFIFO,
+                         operationTxCancelStreamFIFO);
 
     kernel.operationEncode(operationStreamFIFO,
-                           operationEncodeStreamFIFO);
+                           operationCancelStreamFIFO,
+                           operationEncodeStreamFIFO,
+                           operationEncodeCancelStreamFIFO);
 
     kernel.operationProcessTcp(regControl.control,
                                regControl.capture,
@@ -93,15 +134,33 @@ extern "C" void orderEntryTcpTop(orderEntryRegControl_t &regControl,
                                regStatus.txMeta,
                                regStatus.txStatus,
                                regStatus.txDrop,
+                               regStatus.txStall,
+                               regStatus.traceDrop,
                                regCapture,
+                               operationTxStreamFIFO,
+                               operationTxCancelStreamFIFO,
                                operationEncodeStreamFIFO,
+                               operationEncodeCancelStreamFIFO,
                                txMetaStreamPack,
-                               txDataStreamPack);
+                               txDataStreamPack,
+                               traceStreamFIFO);
 
-    kernel.serverProcessTcp(regStatus.rxData,
+    kernel.messageTrace(regTraceHead,
+                        regStatus.traceTail,
+                        traceRing,
+                        traceStreamFIFO);
+
+    kernel.serverProcessTcp(regControl.protocol,
+                            regStatus.rxData,
                             regStatus.rxMeta,
                             rxMetaStreamPack,
-                            rxDataStreamPack);
+                            rxDataStreamPack,
+                            sessionMapStreamFIFO,
+                            execReportStreamFIFO);
+
+    kernel.executionReportDecode(regStatus.rxFill,
+                                 execReportStreamFIFO,
+                                 fillStreamPack);
 
     kernel.notificationHandlerTcp(regStatus.notification,
                                   regStatus.readRequest,
@@ -17,17 +17,103 @@
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <map>
+#include <string>
+#include <vector>
 
 #include "orderentry_kernels.hpp"
 
 #define NUM_TEST_SAMPLE_OE (4)
+#define NUM_TEST_SAMPLE_ASCII (100000)
+
+// unpack an ASCII field, first character is in the most significant byte
+template<int W>
+std::string asciiString(ap_uint<W> field)
+{
+    std::string result;
+    for(int i=(W-8); i>=0; i-=8)
+    {
+        result += (char)(unsigned)field.range(i+7,i);
+    }
+    return result;
+}
+
+std::string zeroPad(std::string value, unsigned width)
+{
+    return std::string((width - value.length()), '0') + value;
+}
+
+// queue a received TCP segment, first byte in the lowest lane of each word
+void rxSegment(hls::stream<ipTcpRxMetaPack_t> &rxMeta,
+               hls::stream<ipTcpRxDataPack_t> &rxData,
+               unsigned sessionID,
+               std::string segment)
+{
+    ipTcpRxMetaPack_t metaPack;
+    ipTcpRxDataPack_t dataPack;
+
+    metaPack.data = sessionID;
+    metaPack.keep = 0x3;
+    metaPack.last = 1;
+    rxMeta.write(metaPack);
+
+    for(size_t i=0; i<segment.length(); i+=OE_MSG_WORD_BYTES)
+    {
+        dataPack.data = 0;
+        dataPack.keep = 0;
+        for(size_t j=0; (j<OE_MSG_WORD_BYTES) && ((i+j)<segment.length()); j++)
+        {
+            dataPack.data.range((j*8)+7,(j*8)) = (unsigned char)segment[i+j];
+            dataPack.keep.range(j,j) = 1;
+        }
+        dataPack.last = ((i+OE_MSG_WORD_BYTES) >= segment.length());
+        rxData.write(dataPack);
+    }
+}
+
+// compare binary to ASCII conversion against std::to_string reference
+unsigned asciiCheck(OrderEntry &kernel, unsigned long long value)
+{
+    unsigned mismatch=0;
+    unsigned long long price=(value & 0xFFFFFFFF);
+    std::string expected;
+
+    expected = zeroPad(std::to_string(value & 0xFFFFFFFF), 10);
+    if(expected != asciiString(kernel.uint32ToAscii(value & 0xFFFFFFFF)))
+    {
+        std::cout << "MISMATCH: uint32ToAscii " << expected << std::endl;
+        ++mismatch;
+    }
+
+    expected = zeroPad(std::to_string(value), 20);
+    if(expected != asciiString(kernel.uint64ToAscii(value)))
+    {
+        std::cout << "MISMATCH: uint64ToAscii " << expected << std::endl;
+        ++mismatch;
+    }
+
+    expected = zeroPad(std::to_string(price / 100000), 5) + "." + zeroPad(std::to_string(price % 100000), 5);
+    if(expected != asciiString(kernel.priceToAscii(price)))
+    {
+        std::cout << "MISMATCH: priceToAscii " << expected << std::endl;
+        ++mismatch;
+    }
+
+    return mismatch;
+}
+
+// egress trace ring, device memory on hardware
+static ap_uint<512> traceRing[OE_TRACE_RING_LEN*OE_TRACE_ENTRY_WORDS];
 
 int main()
 {
     orderEntryRegControl_t regControl={0};
     orderEntryRegStatus_t regStatus={0};
-    ap_uint<1024> regCapture=0x0;
+    ap_uint<OE_MSG_CAPTURE_BITS> regCapture=0x0;
+    orderEntryRegSessionContainer_t regSession;
+    ap_uint<32> regTraceHead=0;
     ap_uint<32> loopCount;
+    ap_uint<16> tcpSessionID=0;
 
     mmInterface intf;
     orderEntryOperation_t operation;
@@ -39,6 +125,8 @@ int main()
     ipTcpListenPortPack_t port;
     ipTuplePack_t connection;
     ipTcpListenStatusPack_t listenStatus_i;
+    orderEntryFill_t fill;
+    orderEntryFillPack_t fillPack;
 
     hls::stream<orderEntryOperationPack_t> operationStreamPackFIFO;
     hls::stream<orderEntryOperationPack_t> operationHostStreamPackFIFO;
@@ -54,33 +142,54 @@ int main()
     hls::stream<ipTcpTxMetaPack_t> txMetaData;
     hls::stream<ipTcpTxDataPack_t> txData;
     hls::stream<ipTcpTxStatusPack_t> txStatus;
+    hls::stream<orderEntryFillPack_t> fillStream;
 
     std::cout << "OrderEntryTcp Test" << std::endl;
     std::cout << "------------------" << std::endl;
 
     orderEntryOperation_t orderEntryOperations[NUM_TEST_SAMPLE_OE] =
     {
-        // timestamp, opCode, symbolIndex, orderId, quantity, price, direction
-        {0x1111111111111111,1,0,123,800,5853400,1},
-        {0x2222222222222222,1,0,234,700,5853500,1},
-        {0x3333333333333333,1,0,345,600,5853600,1},
-        {0x4444444444444444,1,0,456,500,5853700,1},
+        // timestamp, opCode, symbolIndex, orderId, quantity, price, direction, origOrderId
+        {0x1111111111111111,ORDERENTRY_ADD,0,123,800,5853400,1},
+        {0x2222222222222222,ORDERENTRY_MODIFY,0,124,700,5853500,1,123},
+        {0x3333333333333333,ORDERENTRY_DELETE,0,125,700,5853500,1,124},
+        {0x4444444444444444,ORDERENTRY_ADD,0,456,500,5853700,0},
     };
 
     // configure
-    regControl.control = (OE_TCP_GEN_SUM | OE_TCP_CONNECT);
+    regControl.control = (OE_TRACE_ENABLE | OE_TCP_GEN_SUM | OE_TCP_CONNECT);
     regControl.config = 0xdeadbeef;
     regControl.capture = 0x00000000;
     regControl.destAddress = 0x640aa8c0; // 192.168.10.100
     regControl.destPort = 0x17; // telnet (port 23)
+    regControl.sendingDate = 0x20211201; // BCD YYYYMMDD
+    regControl.sendingTime = (OE_TIME_LOAD | 0x235959); // BCD HHMMSS
+
+    // second gateway on session 1, orders for symbol 1 are routed there and
+    // remain FIX while session 0 switches protocol below
+    for(int i=0; i<OE_NUM_SESSION; i++)
+    {
+        regSession.destAddress[i] = 0;
+        regSession.destPort[i] = 0;
+    }
+    for(int i=0; i<NUM_SYMBOL; i++)
+    {
+        regSession.route[i] = 0;
+    }
+    regSession.destAddress[1] = 0x650aa8c0; // 192.168.10.101
+    regSession.destPort[1] = 0x17;
+    regSession.route[1] = 1;
 
-    // kernel calls to connnect
+    // kernel calls to connnect, sessions are brought up one at a time
     std::cout << "Setting up connection ..." << std::endl;
-    for(int i=0; i<NUM_TEST_SAMPLE_OE; i++)
+    for(int i=0; i<(OE_NUM_SESSION*8); i++)
     {
         orderEntryTcpTop(regControl,
                          regStatus,
                          regCapture,
+                         regSession,
+                         regTraceHead,
+                         traceRing,
                          operationStreamPackFIFO,
                          operationHostStreamPackFIFO,
                          listenPort,
@@ -94,7 +203,8 @@ int main()
                          closeConnection,
                          txMetaData,
                          txData,
-                         txStatus);
+                         txStatus,
+                         fillStream);
 
         if (!listenPort.empty())
         {
@@ -110,32 +220,102 @@ int main()
             std::cout << std::dec << "openConnection: " << connection.data << std::endl;
 
             // spoof a connection response
-            txStatusPack.data.range(15,0) = 0x0001; // sessionID
+            ++tcpSessionID;
+            txStatusPack.data.range(15,0) = tcpSessionID; // sessionID
             txStatusPack.data.range(31,16) = 0x0100; // length
             txStatusPack.data.range(61,32) = 0xffff; // space
             txStatusPack.data.range(63,62) = TXSTATUS_SUCCESS;
             txStatus.write(txStatusPack);
-            openConStatusPack.data = 0x10001;
+            openConStatusPack.data = (0x10000 | tcpSessionID);
             openConStatus.write(openConStatusPack);
         }
     }
 
-    // generate input orders
-    std::cout << "Generating input data ..." << std::endl;
-    for(int i=0; i<NUM_TEST_SAMPLE_OE; i++)
+    // each operation is sent once per protocol, FIX ASCII then binary
+    for(int protocol=0; protocol<2; protocol++)
     {
-        operation = orderEntryOperations[i];
-        intf.orderEntryOperationPack(&operation, &operationPack);
-        operationStreamPackFIFO.write(operationPack);
+        regControl.protocol = (protocol ? OE_PROTOCOL_BINARY : 0);
+
+        // generate input orders, once for each routed symbol
+        std::cout << "Generating input data (" << (protocol ? "binary" : "FIX") << ") ..." << std::endl;
+        for(int i=0; i<(NUM_TEST_SAMPLE_OE*2); i++)
+        {
+            operation = orderEntryOperations[i % NUM_TEST_SAMPLE_OE];
+            operation.symbolIndex = (i / NUM_TEST_SAMPLE_OE);
+            intf.orderEntryOperationPack(&operation, &operationPack);
+            operationStreamPackFIFO.write(operationPack);
+        }
+
+        // kernel calls to process operations
+        std::cout << "Invoking kernel execution ..." << std::endl;
+        for(int i=0; i<(NUM_TEST_SAMPLE_OE*2*OE_MSG_NUM_FRAME); i++)
+        {
+            orderEntryTcpTop(regControl,
+                             regStatus,
+                             regCapture,
+                             regSession,
+                             regTraceHead,
+                             traceRing,
+                             operationStreamPackFIFO,
+                             operationHostStreamPackFIFO,
+                             listenPort,
+                             listenStatus,
+                             notifications,
+                             readRequest,
+                             rxMetaData,
+                             rxData,
+                             openConnection,
+                             openConStatus,
+                             closeConnection,
+                             txMetaData,
+                             txData,
+                             txStatus,
+                         fillStream);
+        }
     }
 
-    // kernel calls to process operations
-    std::cout << "Invoking kernel execution ..." << std::endl;
-    for(int i=0; i<(NUM_TEST_SAMPLE_OE*OE_MSG_NUM_FRAME); i++)
+    // execution reports from both gateways, the FIX report on session 1 is
+    // split across two segments with a binary report on session 0 between
+    // them, a heartbeat must not produce a fill, expected fills are:
+    //   0 = binary fill of 200 @ 58.537 for orderId 456
+    //   1 = FIX partial fill of 300 @ 58.534 for orderId 123
+    //   2 = FIX new order acknowledgement for orderId 456
+    std::cout << "Injecting execution reports ..." << std::endl;
+    const unsigned char binaryExecReport[] =
+    {
+        0x32, 0x00, 0xfe, 0xca, 0x26, 0x00, 0x08, 0x00, // header
+        0x01, 0x00, 0x01, 0x00, 0x01, 0x00, 0x00, 0x00, // header, seqNum
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // sendingTime
+        0xc8, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // clOrdId
+        0x04, 0x52, 0x59, 0x00, 0x00, 0x00, 0x00, 0x00, // lastPx
+        0xc8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // lastQty, securityId
+        0x32, 0x00,                                     // execType, side
+    };
+    std::string fixExecReport = "8=FIX.4.2^9=000^35=8^34=1^49=CME^56=ABC123N^37=X1^11=0000000123^17=E1^"
+                                "150=1\x01" "39=1\x01" "55=XLNX\x01" "54=2\x01" "32=300\x01" "31=58.534\x01" "151=500\x01" "10=000\x01";
+    std::string fixHeartbeat = "8=FIX.4.2^9=000^35=0^34=2^49=CME^56=ABC123N^10=000^";
+    std::string fixAck = "8=FIX.4.2^9=000^35=8^34=3^49=CME^56=ABC123N^11=456^150=0^39=0^10=000^";
+
+    rxSegment(rxMetaData, rxData, 2, fixExecReport.substr(0, 45));
+    rxSegment(rxMetaData, rxData, 1, std::string((const char *)binaryExecReport, sizeof(binaryExecReport)));
+    rxSegment(rxMetaData, rxData, 2, fixExecReport.substr(45) + fixHeartbeat + fixAck);
+
+    orderEntryFill_t expectedFills[3] =
+    {
+        // orderId, execType, quantity, price
+        {456,EXEC_FILL,200,5853700},
+        {123,EXEC_PARTIAL_FILL,300,5853400},
+        {456,EXEC_NEW,0,0},
+    };
+
+    for(int i=0; i<(OE_MSG_NUM_FRAME*2); i++)
     {
         orderEntryTcpTop(regControl,
                          regStatus,
                          regCapture,
+                         regSession,
+                         regTraceHead,
+                         traceRing,
                          operationStreamPackFIFO,
                          operationHostStreamPackFIFO,
                          listenPort,
@@ -149,30 +329,287 @@ int main()
                          closeConnection,
                          txMetaData,
                          txData,
-                         txStatus);
+                         txStatus,
+                         fillStream);
+    }
+
+    unsigned fillCount=0, fillMismatch=0;
+    while(!fillStream.empty())
+    {
+        fillPack = fillStream.read();
+        intf.orderEntryFillUnpack(&fillPack, &fill);
+        std::cout << std::dec << "FILL: {" << fill.orderId << "," << (char)(unsigned)fill.execType << ","
+                  << fill.quantity << "," << fill.price << "}" << std::endl;
+
+        if((fillCount >= 3) ||
+           (fill.orderId != expectedFills[fillCount].orderId) ||
+           (fill.execType != expectedFills[fillCount].execType) ||
+           (fill.quantity != expectedFills[fillCount].quantity) ||
+           (fill.price != expectedFills[fillCount].price))
+        {
+            std::cout << "MISMATCH: fill " << fillCount << std::endl;
+            ++fillMismatch;
+        }
+        ++fillCount;
+    }
+    if(3 != fillCount)
+    {
+        ++fillMismatch;
     }
 
     // drain
+    std::vector<unsigned> txMetaSum, txMetaSession, txMetaLength;
+    std::vector<std::string> txPayload;
     std::cout << "DEBUG: TCP Meta Stream" << std::hex << std::endl;
     while(!txMetaData.empty())
     {
         txMetaDataPack = txMetaData.read();
+        txMetaSum.push_back(txMetaDataPack.data.range(47,32));
+        txMetaSession.push_back(txMetaDataPack.data.range(15,0));
+        txMetaLength.push_back(txMetaDataPack.data.range(31,16));
         std::cout << txMetaDataPack.data << std::endl;
     }
 
+    // reference partial checksum summed over every payload byte, compared
+    // against the incremental sum the kernel forwards in the metadata
+    unsigned long referenceSum=0, referenceBytes=0;
+    unsigned checksumCount=0, checksumMismatch=0;
+
+    // FIX session fields are checked on the reassembled payload, body length
+    // (9), checksum (10) and sequence numbers (34) incrementing per session
+    std::string payload;
+    std::map<unsigned, unsigned> fixSequence;
+    unsigned fixCount=0, fixMismatch=0;
+
+    // replace (35=G) and cancel (35=F) carry their own ClOrdID (11) and the
+    // order they refer to in OrigClOrdID (41), which must never repeat 11
+    std::map<std::string, std::string> origClOrdId;
+    std::string clOrdId;
+    unsigned origCount=0, origMismatch=0;
+
+    for(int i=0; i<NUM_TEST_SAMPLE_OE; i++)
+    {
+        if(0 != orderEntryOperations[i].origOrderId)
+        {
+            origClOrdId[zeroPad(std::to_string(orderEntryOperations[i].orderId), 10)] =
+                zeroPad(std::to_string(orderEntryOperations[i].origOrderId), 10);
+        }
+    }
+
     std::cout << "DEBUG: TCP Data Stream" << std::hex << std::endl;
     loopCount = 0;
     while(!txData.empty())
     {
         txDataPack = txData.read();
-        std::cout << txDataPack.data << std::endl;
+        std::cout << txDataPack.data << " " << txDataPack.keep << std::endl;
+        ++loopCount;
+
+        // payload is in network byte order, first byte in the lowest lane
+        for(int i=0; i<OE_MSG_WORD_BYTES; i++)
+        {
+            if(txDataPack.keep.range(i,i))
+            {
+                unsigned payloadByte = txDataPack.data.range((i*8)+7,(i*8));
+                referenceSum += ((referenceBytes++ & 1) ? payloadByte : (payloadByte << 8));
+                payload += (char)payloadByte;
+            }
+        }
 
-        // message line break after every packet
-        if(0 == (++loopCount % OE_MSG_NUM_FRAME))
+        // message line break after every packet, messages vary in length
+        if(txDataPack.last)
         {
+            while(referenceSum >> 16)
+            {
+                referenceSum = ((referenceSum & 0xFFFF) + (referenceSum >> 16));
+            }
+
+            std::cout << "(" << std::dec << loopCount << " frames, ";
+            std::cout << referenceBytes << " bytes, sum " << std::hex << referenceSum << ")" << std::endl;
             std::cout << std::endl;
+
+            if((checksumCount >= txMetaSum.size()) || (referenceSum != txMetaSum[checksumCount]))
+            {
+                std::cout << "MISMATCH: checksum message " << std::dec << checksumCount << std::hex << std::endl;
+                ++checksumMismatch;
+            }
+            if(0 == payload.compare(0, 2, "8=") && (checksumCount < txMetaSession.size()))
+            {
+                size_t bodyStart = (payload.find('^', payload.find('^') + 1) + 1);
+                size_t trailer = (payload.length() - 7);
+                unsigned byteSum=0, sequence;
+
+                for(size_t i=0; i<trailer; i++)
+                {
+                    byteSum += (unsigned char)payload[i];
+                }
+                sequence = std::stoul(payload.substr(payload.find("^34=") + 4, 10));
+
+                if((std::stoul(payload.substr(payload.find("^9=") + 3, 3)) != (trailer - bodyStart)) ||
+                   (payload.substr(trailer, 3) != "10=") ||
+                   (std::stoul(payload.substr(trailer + 3, 3)) != (byteSum % 256)) ||
+                   (sequence != (fixSequence[txMetaSession[checksumCount]] + 1)))
+                {
+                    std::cout << "MISMATCH: FIX session fields message " << std::dec << checksumCount << std::hex << std::endl;
+                    ++fixMismatch;
+                }
+                if(std::string::npos != payload.find("^41="))
+                {
+                    clOrdId = payload.substr(payload.find("^11=") + 4, 10);
+                    if((payload.substr(payload.find("^41=") + 4, 10) == clOrdId) ||
+                       (0 == origClOrdId.count(clOrdId)) ||
+                       (payload.substr(payload.find("^41=") + 4, 10) != origClOrdId[clOrdId]))
+                    {
+                        std::cout << "MISMATCH: OrigClOrdID message " << std::dec << checksumCount << std::hex << std::endl;
+                        ++origMismatch;
+                    }
+                    ++origCount;
+                }
+                std::cout << payload << std::endl;
+                fixSequence[txMetaSession[checksumCount]] = sequence;
+                ++fixCount;
+            }
+            txPayload.push_back(payload);
+            payload.clear();
+            ++checksumCount;
+
+            loopCount = 0;
+            referenceSum = 0;
+            referenceBytes = 0;
+        }
+    }
+
+    // transmit credit, session 0 reports 300B of space with nothing in flight
+    // so the first new order is sent and the second must wait, a cancel
+    // queued behind it is sent first once the space is replenished and
+    // nothing is dropped, expected message lengths are:
+    //   247 = NewOrderSingle, 207 = OrderCancelRequest, 247 = NewOrderSingle
+    std::cout << "Checking transmit credit ..." << std::endl;
+    orderEntryOperation_t creditOperations[3] =
+    {
+        {0x5555555555555555,ORDERENTRY_ADD,0,789,100,5853600,1},
+        {0x6666666666666666,ORDERENTRY_ADD,0,790,100,5853800,0},
+        {0x7777777777777777,ORDERENTRY_DELETE,0,791,100,5853600,1,789},
+    };
+    unsigned creditLength[3] = {247, 207, 247};
+    unsigned long sessionBytes=0;
+    unsigned creditCount=0, creditMismatch=0, creditDrop=regStatus.txDrop;
+
+    for(size_t i=0; i<txMetaSession.size(); i++)
+    {
+        if(1 == txMetaSession[i])
+        {
+            sessionBytes += txMetaLength[i];
+        }
+    }
+
+    regControl.protocol = 0;
+    txStatusPack.data.range(15,0) = 1;
+    txStatusPack.data.range(31,16) = sessionBytes;
+    txStatusPack.data.range(61,32) = 300;
+    txStatusPack.data.range(63,62) = TXSTATUS_SUCCESS;
+    txStatus.write(txStatusPack);
+
+    for(int i=0; i<3; i++)
+    {
+        intf.orderEntryOperationPack(&creditOperations[i], &operationPack);
+        operationStreamPackFIFO.write(operationPack);
+    }
+
+    // frames are sent one per kernel call, allow two messages per step
+    for(int step=0; step<2; step++)
+    {
+        for(int i=0; i<(OE_MSG_NUM_FRAME*2); i++)
+        {
+            orderEntryTcpTop(regControl,
+                             regStatus,
+                             regCapture,
+                             regSession,
+                             regTraceHead,
+                             traceRing,
+                             operationStreamPackFIFO,
+                             operationHostStreamPackFIFO,
+                             listenPort,
+                             listenStatus,
+                             notifications,
+                             readRequest,
+                             rxMetaData,
+                             rxData,
+                             openConnection,
+                             openConStatus,
+                             closeConnection,
+                             txMetaData,
+                             txData,
+                             txStatus,
+                             fillStream);
+        }
+
+        if(0 == step)
+        {
+            if(0 == regStatus.txStall)
+            {
+                std::cout << "MISMATCH: no transmit stall" << std::endl;
+                ++creditMismatch;
+            }
+
+            // acknowledge the first order and open the window
+            txStatusPack.data.range(31,16) = creditLength[0];
+            txStatusPack.data.range(61,32) = 1000;
+            txStatus.write(txStatusPack);
+        }
+    }
+
+    while(!txMetaData.empty())
+    {
+        txMetaDataPack = txMetaData.read();
+        if((creditCount >= 3) || (txMetaDataPack.data.range(31,16) != creditLength[creditCount]))
+        {
+            std::cout << "MISMATCH: credit message " << creditCount << std::endl;
+            ++creditMismatch;
+        }
+        ++creditCount;
+    }
+    while(!txData.empty())
+    {
+        txData.read();
+    }
+    if((3 != creditCount) || (creditDrop != regStatus.txDrop))
+    {
+        ++creditMismatch;
+    }
+
+    // egress trace, one entry per message in transmit order holding the
+    // header fields and the message exactly as sent
+    std::cout << "Checking egress trace ..." << std::endl;
+    unsigned traceCount=0, traceMismatch=0;
+    for(unsigned i=0; i<regStatus.traceTail; i++)
+    {
+        unsigned traceIndex = ((i & (OE_TRACE_RING_LEN-1)) * OE_TRACE_ENTRY_WORDS);
+        unsigned traceLength = traceRing[traceIndex].range(167,152);
+        unsigned traceSession = traceRing[traceIndex].range(143,128);
+        std::string traceMessage;
+
+        for(unsigned j=0; j<traceLength; j++)
+        {
+            traceMessage += (char)(unsigned)traceRing[traceIndex + 1 + (j/64)].range(((j%64)*8)+7,((j%64)*8));
+        }
+
+        if(i < txPayload.size())
+        {
+            if((traceLength != txMetaLength[i]) ||
+               (traceSession != txMetaSession[i]) ||
+               (traceMessage != txPayload[i]))
+            {
+                std::cout << "MISMATCH: trace entry " << i << std::endl;
+                ++traceMismatch;
+            }
+            ++traceCount;
         }
     }
+    regTraceHead = regStatus.traceTail;
+    if((regStatus.traceTail != regStatus.txOrder) || (0 != regStatus.traceDrop))
+    {
+        ++traceMismatch;
+    }
 
     // log final status
     std::cout << "--" << std::hex << std::endl;
@@ -187,10 +624,47 @@ int main()
     std::cout << "OE_RX_META=" << regStatus.rxMeta << " ";
     std::cout << "OE_RX_EVENT=" << regStatus.rxEvent << " ";
     std::cout << "OE_TX_DROP=" << regStatus.txDrop << " ";
+    std::cout << "OE_TX_STALL=" << regStatus.txStall << " ";
+    std::cout << "OE_TRACE_TAIL=" << regStatus.traceTail << " ";
+    std::cout << "OE_TRACE_DROP=" << regStatus.traceDrop << " ";
     std::cout << "OE_TX_STATUS=" << regStatus.txStatus << " ";
     std::cout << "OE_DEBUG=" << regStatus.debug << " ";
+    std::cout << "OE_SESSION_CONNECTED=" << regStatus.sessionConnected << " ";
+    std::cout << "OE_RX_FILL=" << regStatus.rxFill << " ";
     std::cout << std::endl;
 
+    // binary to ASCII conversion, boundaries around each power of ten then
+    // pseudo random values spread across the full 64b range
+    std::cout << "--" << std::dec << std::endl;
+    std::cout << "Checking ASCII conversion ..." << std::endl;
+    OrderEntry converter;
+    unsigned long long value=1, seed=0x123456789abcdefULL;
+    unsigned asciiMismatch=0, asciiCount=0;
+    asciiMismatch += asciiCheck(converter, 0);
+    asciiMismatch += asciiCheck(converter, ~0ULL);
+    asciiCount += 2;
+    for(int i=0; i<20; i++)
+    {
+        asciiMismatch += asciiCheck(converter, value-1);
+        asciiMismatch += asciiCheck(converter, value);
+        asciiMismatch += asciiCheck(converter, value+1);
+        asciiCount += 3;
+        value *= 10;
+    }
+    for(int i=0; i<NUM_TEST_SAMPLE_ASCII; i++)
+    {
+        seed = (seed * 6364136223846793005ULL) + 1442695040888963407ULL;
+        asciiMismatch += asciiCheck(converter, (seed >> (i % 40)));
+        ++asciiCount;
+    }
+    std::cout << "ASCII: checked " << asciiCount << " values, " << asciiMismatch << " mismatches" << std::endl;
+    std::cout << "CHECKSUM: checked " << checksumCount << " messages, " << checksumMismatch << " mismatches" << std::endl;
+    std::cout << "FIX: checked " << fixCount << " messages, " << fixMismatch << " mismatches" << std::endl;
+    std::cout << "ORIG: checked " << origCount << " messages, " << origMismatch << " mismatches" << std::endl;
+    std::cout << "FILL: checked " << fillCount << " reports, " << fillMismatch << " mismatches" << std::endl;
+    std::cout << "TRACE: checked " << traceCount << " entries, " << traceMismatch << " mismatches" << std::endl;
+    std::cout << "CREDIT: checked " << creditCount << " messages, " << creditMismatch << " mismatches" << std::endl;
+
     std::cout << std::endl;
     std::cout << "Done!" << std::endl;
 
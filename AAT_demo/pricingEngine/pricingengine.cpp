@@ -21,7 +21,10 @@
  * PricingEngine Core
  */
 
-void PricingEngine::responsePull(ap_uint<32> &regRxResponse,
+void PricingEngine::responsePull(ap_uint<32> &regResponseControl,
+                                 ap_uint<32> &regRxResponse,
+                                 ap_uint<32> &regConflateDefer,
+                                 ap_uint<32> &regConflateDrop,
                                  hls::stream<orderBookResponsePack_t> &responseStreamPack,
                                  hls::stream<orderBookResponse_t> &responseStream)
 {
@@ -30,42 +33,173 @@ void PricingEngine::responsePull(ap_uint<32> &regRxResponse,
     mmInterface intf;
     orderBookResponsePack_t responsePack;
     orderBookResponse_t response;
+    ap_uint<8> symbolIndex=0;
+    ap_uint<8> pendingIndex=0;
 
     static ap_uint<32> countRxResponse=0;
+    static ap_uint<32> countConflateDefer=0;
+    static ap_uint<32> countConflateDrop=0;
+
+    // symbols with a deferred response, in order of first deferral, each
+    // symbol is queued at most once so depth covers the full symbol range
+    static hls::stream<ap_uint<8> > pendingStream;
+#pragma HLS STREAM variable=pendingStream depth=256
+
+    // when the pricing process applies backpressure responses are conflated
+    // per symbol rather than queued, only the newest book for a symbol is
+    // held so the next decision acts on current state instead of working
+    // through a backlog of intermediate books
+    if(!pendingStream.empty())
+    {
+        if(!responseStream.full())
+        {
+            pendingIndex = pendingStream.read();
+            responseStream.write(conflate[pendingIndex]);
+            conflateValid[pendingIndex] = 0;
+        }
+
+        // deferred responses still draining, new arrivals join the table to
+        // preserve ordering across symbols, with conflation disabled the
+        // table is flushed first and arrivals are held back in the input
+        // stream rather than conflated
+        if(!responseStreamPack.empty() && !(PE_CONFLATE_DISABLE & regResponseControl))
+        {
+            responsePack = responseStreamPack.read();
+            intf.orderBookResponseUnpack(&responsePack, &response);
+            ++countRxResponse;
 
-    if(!responseStreamPack.empty())
+            symbolIndex = response.symbolIndex;
+            if(conflateValid[symbolIndex])
+            {
+                ++countConflateDrop;
+            }
+            else
+            {
+                pendingStream.write(symbolIndex);
+                conflateValid[symbolIndex] = 1;
+                ++countConflateDefer;
+            }
+            conflate[symbolIndex] = response;
+        }
+    }
+    else if(!responseStreamPack.empty())
     {
         responsePack = responseStreamPack.read();
         intf.orderBookResponseUnpack(&responsePack, &response);
-        responseStream.write(response);
         ++countRxResponse;
+
+        if((PE_CONFLATE_DISABLE & regResponseControl) || !responseStream.full())
+        {
+            responseStream.write(response);
+        }
+        else
+        {
+            symbolIndex = response.symbolIndex;
+            pendingStream.write(symbolIndex);
+            conflate[symbolIndex] = response;
+            conflateValid[symbolIndex] = 1;
+            ++countConflateDefer;
+        }
     }
 
     regRxResponse = countRxResponse;
+    regConflateDefer = countConflateDefer;
+    regConflateDrop = countConflateDrop;
+
+    return;
+}
+
+void PricingEngine::eventPull(ap_uint<32> &regRxEvent,
+                              hls::stream<clockTickGeneratorEvent_t> &eventStreamPack,
+                              hls::stream<ap_uint<8> > &eventStream)
+{
+#pragma HLS PIPELINE II=1 style=flp
+
+    clockTickGeneratorEvent_t tickEvent;
+
+    static ap_uint<32> countRxEvent=0;
+
+    // event notification from programmable clock tick generator, forwarded
+    // to the pricing process to drive quote aging when the market is quiet
+    if(!eventStreamPack.empty())
+    {
+        tickEvent = eventStreamPack.read();
+        eventStream.write(tickEvent.data);
+        ++countRxEvent;
+    }
+
+    regRxEvent = countRxEvent;
+
+    return;
+}
+
+void PricingEngine::fillPull(ap_uint<32> &regRxFill,
+                             hls::stream<orderEntryFillPack_t> &fillStreamPack,
+                             hls::stream<orderEntryFill_t> &fillStream)
+{
+#pragma HLS PIPELINE II=1 style=flp
+
+    mmInterface intf;
+    orderEntryFillPack_t fillPack;
+    orderEntryFill_t fill;
+
+    static ap_uint<32> countRxFill=0;
+
+    // execution reports parsed by OrderEntry from the gateway sessions
+    if(!fillStreamPack.empty())
+    {
+        fillPack = fillStreamPack.read();
+        intf.orderEntryFillUnpack(&fillPack, &fill);
+        fillStream.write(fill);
+        ++countRxFill;
+    }
+
+    regRxFill = countRxFill;
 
     return;
 }
 
 void PricingEngine::pricingProcess(ap_uint<32> &regStrategyControl,
+                                   ap_uint<32> &regCacheControl,
+                                   ap_uint<32> &regCacheWarmup,
+                                   ap_uint<32> &regQuoteTimeInForce,
+                                   ap_uint<32> &regQuoteHeartbeat,
+                                   ap_uint<32> &regParamCommit,
+                                   ap_uint<32> &regPositionSelect,
                                    ap_uint<32> &regProcessResponse,
                                    ap_uint<32> &regStrategyNone,
                                    ap_uint<32> &regStrategyPeg,
                                    ap_uint<32> &regStrategyLimit,
                                    ap_uint<32> &regStrategyUnknown,
-                                   pricingEngineRegStrategy_t *regStrategies,
+                                   ap_uint<32> &regStrategySpread,
+                                   ap_uint<32> &regCacheCold,
+                                   ap_uint<32> &regQuoteCancel,
+                                   ap_uint<32> &regQuoteRefresh,
+                                   ap_uint<32> &regParamBank,
+                                   ap_uint<32> &regParamCommitCount,
+                                   ap_uint<32> &regFillTrade,
+                                   ap_uint<32> &regFillUnknown,
+                                   ap_uint<32> &regPosition,
+                                   pricingEngineRegStrategy_t regStrategies[PE_NUM_PARAM_BANK][NUM_SYMBOL],
+                                   pricingEngineRegLegs_t regLegs[PE_NUM_PARAM_BANK][NUM_SYMBOL],
                                    hls::stream<orderBookResponse_t> &responseStream,
+                                   hls::stream<ap_uint<8> > &eventStream,
+                                   hls::stream<orderEntryFill_t> &fillStream,
                                    hls::stream<orderEntryOperation_t> &operationStream)
 {
 #pragma HLS PIPELINE II=1 style=flp
 
-    mmInterface intf;
     orderBookResponse_t response;
     orderEntryOperation_t operation;
+    orderEntryFill_t fill;
+    pricingEngineOrderEntry_t orderEntry;
     ap_uint<8> symbolIndex=0;
     ap_uint<8> strategySelect=0;
     ap_uint<8> thresholdEnable=0;
     ap_uint<8> thresholdPosition=0;
+    ap_uint<8> invalidateIndex=0;
     bool orderExecute=false;
+    bool sweepTurn=false;
 
     static ap_uint<32> orderId=0;
     static ap_uint<32> countProcessResponse=0;
@@ -73,14 +207,180 @@ void PricingEngine::pricingProcess(ap_uint<32> &regStrategyControl,
     static ap_uint<32> countStrategyPeg=0;
     static ap_uint<32> countStrategyLimit=0;
     static ap_uint<32> countStrategyUnknown=0;
+    static ap_uint<32> countStrategySpread=0;
+    static ap_uint<32> countCacheCold=0;
+    static ap_uint<32> countQuoteCancel=0;
+    static ap_uint<32> countQuoteRefresh=0;
+    static ap_uint<32> countTick=0;
+    static ap_uint<32> countParamCommit=0;
+    static ap_uint<32> countFillTrade=0;
+    static ap_uint<32> countFillUnknown=0;
+    static ap_uint<8> sweepIndex=0;
+    static ap_uint<9> sweepRemain=0;
+    static ap_uint<1> sweepLast=0;
+    static ap_uint<1> invalidatePrev=0;
+    static ap_uint<1> paramBank=0;
+
+    // host triggered cache invalidate for a single symbol, acted on when the
+    // control bit transitions from clear to set so the host can leave it set
+    // without repeatedly resetting the symbol, the symbol must then see the
+    // programmed number of warm-up updates before it is allowed to trade
+    if((PE_CACHE_INVALIDATE & regCacheControl) && (0 == invalidatePrev))
+    {
+        invalidateIndex = regCacheControl.range(7,0);
+        cache[invalidateIndex].valid = false;
+        cache[invalidateIndex].count = 0;
+        for(int i=0; i<PE_NUM_LEG; i++)
+        {
+#pragma HLS UNROLL
+            legCache[i][invalidateIndex].valid = 0;
+        }
+    }
+    invalidatePrev = ((PE_CACHE_INVALIDATE & regCacheControl) != 0);
+
+    // strategy parameters are double buffered, host programs the inactive
+    // bank then selects it with a single commit register write, the bank is
+    // latched once per cycle whatever the cycle processes so a response never
+    // sees a mix of old and new parameters and the commit is acknowledged
+    // while the market is quiet, the host can reuse the previous bank once
+    // the paramBank status register reflects the commit
+    if(paramBank != regParamCommit.range(0,0))
+    {
+        paramBank = regParamCommit.range(0,0);
+        ++countParamCommit;
+    }
 
-    if(!responseStream.empty())
+    // clock tick, quote age is measured in ticks, consumed every cycle so the
+    // count keeps time whatever the market is doing, each tick schedules a
+    // sweep of every symbol against the timer thresholds
+    if(!eventStream.empty())
+    {
+        eventStream.read();
+        ++countTick;
+        sweepRemain = NUM_SYMBOL;
+    }
+
+    // execution reports are served first, their rate is bounded by the
+    // orders issued so they cannot starve market data, and position and the
+    // resting quotes must be current before the next book is priced, a
+    // scheduled sweep takes the remaining idle cycles and, while market data
+    // is pending, alternates with it so a stale quote is still cancelled
+    // within a bounded number of cycles under sustained market data
+    sweepTurn = (fillStream.empty() && (0 != sweepRemain) &&
+                 (!sweepLast || responseStream.empty()));
+
+    if(!fillStream.empty())
+    {
+        // execution report, attributed to a symbol through the issued order
+        // table, reports for orders since overwritten in the table are only
+        // counted as they can no longer be matched
+        fill = fillStream.read();
+        orderEntry = order[fill.orderId & (PE_NUM_ORDER-1)];
+
+        if(orderEntry.valid && (orderEntry.orderId == fill.orderId))
+        {
+            symbolIndex = orderEntry.symbolIndex;
+
+            switch(fill.execType)
+            {
+                case EXEC_PARTIAL_FILL:
+                case EXEC_FILL:
+                case EXEC_TRADE:
+                {
+                    ++countFillTrade;
+                    if(ORDER_BID == orderEntry.direction)
+                    {
+                        position[symbolIndex] += fill.quantity;
+                    }
+                    else
+                    {
+                        position[symbolIndex] -= fill.quantity;
+                    }
+
+                    // resting quote shrinks by the executed quantity and is
+                    // closed once fully filled so timers no longer act on it
+                    if(quote[symbolIndex].open && (quote[symbolIndex].orderId == fill.orderId))
+                    {
+                        if(fill.quantity >= quote[symbolIndex].quantity)
+                        {
+                            quote[symbolIndex].quantity = 0;
+                            quote[symbolIndex].open = 0;
+                        }
+                        else
+                        {
+                            quote[symbolIndex].quantity -= fill.quantity;
+                        }
+                    }
+                    break;
+                }
+                case EXEC_CANCELED:
+                case EXEC_REJECTED:
+                case EXEC_EXPIRED:
+                {
+                    if(quote[symbolIndex].orderId == fill.orderId)
+                    {
+                        quote[symbolIndex].open = 0;
+                    }
+                    break;
+                }
+                default:
+                {
+                    // acknowledgements (new, replaced) carry no state change
+                    break;
+                }
+            }
+        }
+        else
+        {
+            ++countFillUnknown;
+        }
+    }
+    else if(sweepTurn)
+    {
+        // check the resting quote of one symbol per cycle
+        if(quoteTimer(sweepIndex,
+                      countTick,
+                      regQuoteTimeInForce,
+                      regQuoteHeartbeat,
+                      operation))
+        {
+            // a modify or cancel is a new request with its own ClOrdID, the
+            // quote and issued order table follow it so the replace or
+            // cancel acknowledgement and later fills are still attributed
+            operation.orderId = ++orderId;
+            quote[sweepIndex].orderId = operation.orderId;
+            order[operation.orderId & (PE_NUM_ORDER-1)].orderId = operation.orderId;
+            order[operation.orderId & (PE_NUM_ORDER-1)].symbolIndex = sweepIndex;
+            order[operation.orderId & (PE_NUM_ORDER-1)].direction = operation.direction;
+            order[operation.orderId & (PE_NUM_ORDER-1)].valid = 1;
+
+            if(ORDERENTRY_DELETE == operation.opCode)
+            {
+                ++countQuoteCancel;
+            }
+            else
+            {
+                ++countQuoteRefresh;
+            }
+            operationStream.write(operation);
+        }
+        ++sweepIndex;
+        --sweepRemain;
+    }
+    else if(!responseStream.empty())
     {
         response = responseStream.read();
         ++countProcessResponse;
 
         symbolIndex = response.symbolIndex;
-        thresholdEnable = regStrategies[symbolIndex].enable.range(7,0);
+
+        // strategies act on deltas from the cached top of book, responses for
+        // a symbol still warming up are counted here and dropped by strategy
+        if(!cache[symbolIndex].valid)
+        {
+            ++countCacheCold;
+        }
+        thresholdEnable = regStrategies[paramBank][symbolIndex].enable.range(7,0);
 
         // global strategy select override (across all symbols) for debug
         if(PE_GLOBAL_STRATEGY & regStrategyControl)
@@ -89,7 +389,7 @@ void PricingEngine::pricingProcess(ap_uint<32> &regStrategyControl,
         }
         else
         {
-            strategySelect = regStrategies[symbolIndex].select.range(7,0);
+            strategySelect = regStrategies[paramBank][symbolIndex].select.range(7,0);
         }
 
         switch(strategySelect)
@@ -119,6 +419,14 @@ void PricingEngine::pricingProcess(ap_uint<32> &regStrategyControl,
                                                     operation);
                 break;
             }
+            case(STRATEGY_SPREAD):
+            {
+                ++countStrategySpread;
+                orderExecute = pricingStrategySpread(regLegs[paramBank][symbolIndex],
+                                                     response,
+                                                     operation);
+                break;
+            }
             default:
             {
                 ++countStrategyUnknown;
@@ -127,18 +435,48 @@ void PricingEngine::pricingProcess(ap_uint<32> &regStrategyControl,
             }
         }
 
+        // cache top of book prices (used as trigger on next delta if change
+        // detected), updated independent of strategy so a strategy switch
+        // does not act on a stale entry
+        cacheUpdate(regCacheWarmup, response);
+
         if(orderExecute)
         {
             operation.orderId = ++orderId;
+            operation.origOrderId = 0;
             operationStream.write(operation);
+
+            // track latest order as the resting quote for timer handling
+            quote[symbolIndex].orderId = operation.orderId;
+            quote[symbolIndex].quantity = operation.quantity;
+            quote[symbolIndex].price = operation.price;
+            quote[symbolIndex].direction = operation.direction;
+            quote[symbolIndex].tickPlaced = countTick;
+            quote[symbolIndex].tickRefresh = countTick;
+            quote[symbolIndex].open = 1;
+
+            order[operation.orderId & (PE_NUM_ORDER-1)].orderId = operation.orderId;
+            order[operation.orderId & (PE_NUM_ORDER-1)].symbolIndex = symbolIndex;
+            order[operation.orderId & (PE_NUM_ORDER-1)].direction = operation.direction;
+            order[operation.orderId & (PE_NUM_ORDER-1)].valid = 1;
         }
     }
+    sweepLast = sweepTurn;
 
     regProcessResponse = countProcessResponse;
     regStrategyNone = countStrategyNone;
     regStrategyPeg = countStrategyPeg;
     regStrategyLimit = countStrategyLimit;
     regStrategyUnknown = countStrategyUnknown;
+    regStrategySpread = countStrategySpread;
+    regCacheCold = countCacheCold;
+    regQuoteCancel = countQuoteCancel;
+    regQuoteRefresh = countQuoteRefresh;
+    regParamBank = paramBank;
+    regParamCommitCount = countParamCommit;
+    regFillTrade = countFillTrade;
+    regFillUnknown = countFillUnknown;
+    regPosition = position[regPositionSelect.range(7,0)];
 
     return;
 }
@@ -155,8 +493,7 @@ bool PricingEngine::pricingStrategyPeg(ap_uint<8> thresholdEnable,
 
     symbolIndex = response.symbolIndex;
 
-    // TODO: restore valid check when test data updated to trigger top of book update
-    //if(cache[symbolIndex].valid)
+    if(cache[symbolIndex].valid)
     {
         if(cache[symbolIndex].bidPrice != response.bidPrice.range(31,0))
         {
@@ -171,11 +508,6 @@ bool PricingEngine::pricingStrategyPeg(ap_uint<8> thresholdEnable,
         }
     }
 
-    // cache top of book prices (used as trigger on next delta if change detected)
-    cache[symbolIndex].bidPrice = response.bidPrice.range(31,0);
-    cache[symbolIndex].askPrice = response.askPrice.range(31,0);
-    cache[symbolIndex].valid = true;
-
     return executeOrder;
 }
 
@@ -191,8 +523,7 @@ bool PricingEngine::pricingStrategyLimit(ap_uint<8> thresholdEnable,
 
     symbolIndex = response.symbolIndex;
 
-    // TODO: restore valid check when test data updated to trigger top of book update
-    //if(cache[symbolIndex].valid)
+    if(cache[symbolIndex].valid)
     {
         if(cache[symbolIndex].bidPrice != response.bidPrice.range(31,0))
         {
@@ -207,10 +538,160 @@ bool PricingEngine::pricingStrategyLimit(ap_uint<8> thresholdEnable,
         }
     }
 
-    // cache top of book prices (used as trigger on next delta if change detected)
+    return executeOrder;
+}
+
+bool PricingEngine::pricingStrategySpread(pricingEngineRegLegs_t &legs,
+                                          orderBookResponse_t &response,
+                                          orderEntryOperation_t &operation)
+{
+#pragma HLS PIPELINE II=1 style=flp
+
+    ap_uint<8> symbolIndex=0;
+    ap_uint<8> legIndex=0;
+    ap_int<8> weight=0;
+    ap_int<34> midPrice=0;
+    ap_int<48> spread=0;
+    ap_int<48> threshold=0;
+    bool legsValid=true;
+    bool executeOrder=false;
+
+    symbolIndex = response.symbolIndex;
+    threshold = legs.threshold;
+
+    // weighted sum of mid prices across the group, the updating symbol uses
+    // the live response while other legs use their cached top of book
+    weight = legs.weights.range(31,24);
+    midPrice = ((response.bidPrice.range(31,0) + response.askPrice.range(31,0)) >> 1);
+    spread = (weight * midPrice);
+
+    for(int i=0; i<PE_NUM_LEG; i++)
+    {
+#pragma HLS UNROLL
+        legIndex = legs.legs.range((i*8)+7,(i*8));
+        weight = legs.weights.range((i*8)+7,(i*8));
+        if(0 != weight)
+        {
+            midPrice = legCache[i][legIndex].midPrice;
+            spread += (weight * midPrice);
+            legsValid = (legsValid && legCache[i][legIndex].valid);
+        }
+    }
+
+    if(cache[symbolIndex].valid && legsValid)
+    {
+        // symbol trading rich to the group, offer at current best ask
+        if(spread > threshold)
+        {
+            operation.timestamp = response.timestamp;
+            operation.opCode = ORDERENTRY_ADD;
+            operation.symbolIndex = symbolIndex;
+            operation.quantity = legs.quantity;
+            operation.price = response.askPrice.range(31,0);
+            operation.direction = ORDER_ASK;
+            executeOrder = true;
+        }
+        // symbol trading cheap to the group, bid at current best bid
+        else if(spread < -threshold)
+        {
+            operation.timestamp = response.timestamp;
+            operation.opCode = ORDERENTRY_ADD;
+            operation.symbolIndex = symbolIndex;
+            operation.quantity = legs.quantity;
+            operation.price = response.bidPrice.range(31,0);
+            operation.direction = ORDER_BID;
+            executeOrder = true;
+        }
+    }
+
+    return executeOrder;
+}
+
+void PricingEngine::cacheUpdate(ap_uint<32> warmupThreshold,
+                                orderBookResponse_t &response)
+{
+#pragma HLS INLINE
+
+    ap_uint<8> symbolIndex=0;
+    ap_uint<32> midPrice=0;
+
+    symbolIndex = response.symbolIndex;
+
     cache[symbolIndex].bidPrice = response.bidPrice.range(31,0);
     cache[symbolIndex].askPrice = response.askPrice.range(31,0);
-    cache[symbolIndex].valid = true;
+
+    // entry becomes valid once the warm-up count of updates has been seen,
+    // count is incremented first so a threshold of zero still requires one
+    // update to give the strategies a previous value to compare against
+    if(!cache[symbolIndex].valid)
+    {
+        ++cache[symbolIndex].count;
+        if(cache[symbolIndex].count >= warmupThreshold)
+        {
+            cache[symbolIndex].valid = true;
+        }
+    }
+
+    midPrice = ((response.bidPrice.range(31,0) + response.askPrice.range(31,0)) >> 1);
+    for(int i=0; i<PE_NUM_LEG; i++)
+    {
+#pragma HLS UNROLL
+        legCache[i][symbolIndex].midPrice = midPrice;
+        legCache[i][symbolIndex].valid = cache[symbolIndex].valid;
+    }
+
+    return;
+}
+
+bool PricingEngine::quoteTimer(ap_uint<8> symbolIndex,
+                               ap_uint<32> tickCount,
+                               ap_uint<32> timeInForce,
+                               ap_uint<32> heartbeat,
+                               orderEntryOperation_t &operation)
+{
+#pragma HLS INLINE
+
+    bool executeOrder=false;
+
+    // threshold of zero disables the respective timer
+    if(quote[symbolIndex].open)
+    {
+        if((0 != timeInForce) &&
+           ((tickCount - quote[symbolIndex].tickPlaced) >= timeInForce))
+        {
+            // quote has exceeded time-in-force, cancel
+            operation.opCode = ORDERENTRY_DELETE;
+            operation.price = quote[symbolIndex].price;
+            quote[symbolIndex].open = 0;
+            executeOrder = true;
+        }
+        else if((0 != heartbeat) &&
+                ((tickCount - quote[symbolIndex].tickRefresh) >= heartbeat) &&
+                cache[symbolIndex].valid)
+        {
+            // re-quote at the cached top of book for the resting side, held
+            // off while the symbol is invalidated or warming up so a refresh
+            // never uses a cleared or stale entry
+            operation.opCode = ORDERENTRY_MODIFY;
+            if(ORDER_BID == quote[symbolIndex].direction)
+            {
+                operation.price = cache[symbolIndex].bidPrice;
+            }
+            else
+            {
+                operation.price = cache[symbolIndex].askPrice;
+            }
+            quote[symbolIndex].price = operation.price;
+            quote[symbolIndex].tickRefresh = tickCount;
+            executeOrder = true;
+        }
+
+        operation.timestamp = tickCount;
+        operation.symbolIndex = symbolIndex;
+        operation.origOrderId = quote[symbolIndex].orderId;
+        operation.quantity = quote[symbolIndex].quantity;
+        operation.direction = quote[symbolIndex].direction;
+    }
 
     return executeOrder;
 }
@@ -22,8 +22,19 @@
 #include "aat_defines.hpp"
 #include "aat_interfaces.hpp"
 
-#define PE_GLOBAL_STRATEGY (1<<31)
-#define PE_CAPTURE_FREEZE  (1<<31)
+#define PE_GLOBAL_STRATEGY  (1<<31)
+#define PE_CAPTURE_FREEZE   (1<<31)
+#define PE_CACHE_INVALIDATE (1<<31)
+#define PE_CONFLATE_DISABLE (1<<0)
+
+// responses queued ahead of the pricing process, conflation starts once full
+#define PE_RESPONSE_QUEUE_DEPTH (8)
+
+#define PE_NUM_LEG        (3)
+#define PE_NUM_PARAM_BANK (2)
+
+// recently issued orders kept for fill attribution, power of two
+#define PE_NUM_ORDER      (1024)
 
 typedef struct pricingEngineRegControl_t
 {
@@ -31,10 +42,18 @@ typedef struct pricingEngineRegControl_t
     ap_uint<32> config;
     ap_uint<32> capture;
     ap_uint<32> strategy;
-    ap_uint<32> reserved04;
-    ap_uint<32> reserved05;
-    ap_uint<32> reserved06;
-    ap_uint<32> reserved07;
+    ap_uint<32> cacheControl;
+    ap_uint<32> cacheWarmup;
+    ap_uint<32> quoteTimeInForce;
+    ap_uint<32> quoteHeartbeat;
+    ap_uint<32> paramCommit;
+    ap_uint<32> responseControl;
+    ap_uint<32> positionSelect;
+    ap_uint<32> reserved11;
+    ap_uint<32> reserved12;
+    ap_uint<32> reserved13;
+    ap_uint<32> reserved14;
+    ap_uint<32> reserved15;
 } pricingEngineRegControl_t;
 
 typedef struct pricingEngineRegStatus_t
@@ -49,12 +68,20 @@ typedef struct pricingEngineRegStatus_t
     ap_uint<32> strategyUnknown;
     ap_uint<32> rxEvent;
     ap_uint<32> debug;
-    ap_uint<32> reserved10;
-    ap_uint<32> reserved11;
-    ap_uint<32> reserved12;
-    ap_uint<32> reserved13;
-    ap_uint<32> reserved14;
-    ap_uint<32> reserved15;
+    ap_uint<32> cacheCold;
+    ap_uint<32> strategySpread;
+    ap_uint<32> quoteCancel;
+    ap_uint<32> quoteRefresh;
+    ap_uint<32> paramBank;
+    ap_uint<32> paramCommit;
+    ap_uint<32> conflateDefer;
+    ap_uint<32> conflateDrop;
+    ap_uint<32> rxFill;
+    ap_uint<32> fillTrade;
+    ap_uint<32> fillUnknown;
+    ap_uint<32> position;
+    ap_uint<32> reserved22;
+    ap_uint<32> reserved23;
 } pricingEngineRegStatus_t;
 
 typedef struct pricingEngineRegStrategy_t
@@ -80,13 +107,56 @@ typedef struct pricingEngineRegThresholds_t
     ap_uint<32> threshold7;
 } pricingEngineRegThresholds_t;
 
+// leg map for multi-instrument strategies (pairs, calendar spreads, ETF vs
+// basket), each symbol carries its own view of the other legs in the group so
+// an update to any leg can be evaluated without a reverse lookup, unused legs
+// are programmed with a zero weight
+typedef struct pricingEngineRegLegs_t
+{
+    ap_uint<32> legs;      // [23:16] leg 2, [15:8] leg 1, [7:0] leg 0 symbol index
+    ap_uint<32> weights;   // [31:24] self, [23:16] leg 2, [15:8] leg 1, [7:0] leg 0 (signed)
+    ap_uint<32> threshold; // weighted mid price spread required to trigger an order
+    ap_uint<32> quantity;
+} pricingEngineRegLegs_t;
+
 typedef struct pricingEngineCacheEntry_t
 {
     ap_uint<32> bidPrice;
     ap_uint<32> askPrice;
     ap_uint<32> valid;
+    ap_uint<32> count; // updates cached since last invalidate, used for warm-up
 } pricingEngineCacheEntry_t;
 
+// copy of the cached mid price read by the spread strategy for one leg
+typedef struct pricingEngineLegCacheEntry_t
+{
+    ap_uint<32> midPrice;
+    ap_uint<1>  valid;
+} pricingEngineLegCacheEntry_t;
+
+// most recent order placed per symbol, aged against clock tick events so a
+// resting quote can be refreshed on a heartbeat or cancelled once stale
+typedef struct pricingEngineQuoteEntry_t
+{
+    ap_uint<32> orderId;
+    ap_uint<32> quantity;
+    ap_uint<32> price;
+    ap_uint<8>  direction;
+    ap_uint<32> tickPlaced;
+    ap_uint<32> tickRefresh;
+    ap_uint<1>  open;
+} pricingEngineQuoteEntry_t;
+
+// issued order indexed by the low bits of orderId, lets an execution report
+// which only carries the orderId be attributed to its symbol and side
+typedef struct pricingEngineOrderEntry_t
+{
+    ap_uint<32> orderId;
+    ap_uint<8>  symbolIndex;
+    ap_uint<8>  direction;
+    ap_uint<1>  valid;
+} pricingEngineOrderEntry_t;
+
 /**
  * PricingEngine Core
  */
@@ -94,18 +164,55 @@ class PricingEngine
 {
 public:
 
-    void responsePull(ap_uint<32> &regRxResponse,
+    PricingEngine()
+    {
+#pragma HLS INLINE
+        // one copy of the leg cache per leg, each with its own read port
+#pragma HLS ARRAY_PARTITION variable=legCache complete dim=1
+#pragma HLS ARRAY_PARTITION variable=conflateValid complete
+    }
+
+    void responsePull(ap_uint<32> &regResponseControl,
+                      ap_uint<32> &regRxResponse,
+                      ap_uint<32> &regConflateDefer,
+                      ap_uint<32> &regConflateDrop,
                       hls::stream<orderBookResponsePack_t> &responseStreamPack,
                       hls::stream<orderBookResponse_t> &responseStream);
 
+    void eventPull(ap_uint<32> &regRxEvent,
+                   hls::stream<clockTickGeneratorEvent_t> &eventStreamPack,
+                   hls::stream<ap_uint<8> > &eventStream);
+
+    void fillPull(ap_uint<32> &regRxFill,
+                  hls::stream<orderEntryFillPack_t> &fillStreamPack,
+                  hls::stream<orderEntryFill_t> &fillStream);
+
     void pricingProcess(ap_uint<32> &regStrategyControl,
+                        ap_uint<32> &regCacheControl,
+                        ap_uint<32> &regCacheWarmup,
+                        ap_uint<32> &regQuoteTimeInForce,
+                        ap_uint<32> &regQuoteHeartbeat,
+                        ap_uint<32> &regParamCommit,
+                        ap_uint<32> &regPositionSelect,
                         ap_uint<32> &regProcessResponse,
                         ap_uint<32> &regStrategyNone,
                         ap_uint<32> &regStrategyPeg,
                         ap_uint<32> &regStrategyLimit,
                         ap_uint<32> &regStrategyUnknown,
-                        pricingEngineRegStrategy_t *regStrategies,
+                        ap_uint<32> &regStrategySpread,
+                        ap_uint<32> &regCacheCold,
+                        ap_uint<32> &regQuoteCancel,
+                        ap_uint<32> &regQuoteRefresh,
+                        ap_uint<32> &regParamBank,
+                        ap_uint<32> &regParamCommitCount,
+                        ap_uint<32> &regFillTrade,
+                        ap_uint<32> &regFillUnknown,
+                        ap_uint<32> &regPosition,
+                        pricingEngineRegStrategy_t regStrategies[PE_NUM_PARAM_BANK][NUM_SYMBOL],
+                        pricingEngineRegLegs_t regLegs[PE_NUM_PARAM_BANK][NUM_SYMBOL],
                         hls::stream<orderBookResponse_t> &responseStream,
+                        hls::stream<ap_uint<8> > &eventStream,
+                        hls::stream<orderEntryFill_t> &fillStream,
                         hls::stream<orderEntryOperation_t> &operationStream);
 
     bool pricingStrategyPeg(ap_uint<8> thresholdEnable,
@@ -118,6 +225,10 @@ public:
                               orderBookResponse_t &response,
                               orderEntryOperation_t &operation);
 
+    bool pricingStrategySpread(pricingEngineRegLegs_t &legs,
+                               orderBookResponse_t &response,
+                               orderEntryOperation_t &operation);
+
     void operationPush(ap_uint<32> &regCaptureControl,
                        ap_uint<32> &regTxOperation,
                        ap_uint<1024> &regCaptureBuffer,
@@ -127,8 +238,33 @@ public:
 
 private:
 
+    void cacheUpdate(ap_uint<32> warmupThreshold,
+                     orderBookResponse_t &response);
+
+    bool quoteTimer(ap_uint<8> symbolIndex,
+                    ap_uint<32> tickCount,
+                    ap_uint<32> timeInForce,
+                    ap_uint<32> heartbeat,
+                    orderEntryOperation_t &operation);
+
     //pricingEngineRegThresholds_t thresholds[NUM_SYMBOL];
     pricingEngineCacheEntry_t cache[NUM_SYMBOL];
+    pricingEngineQuoteEntry_t quote[NUM_SYMBOL];
+
+    // the spread strategy reads the cached mid price of every leg in the same
+    // cycle as the triggering update, the cache is replicated per leg rather
+    // than partitioned so any symbol can be mapped to any leg at the cost of
+    // a write to each copy on update
+    pricingEngineLegCacheEntry_t legCache[PE_NUM_LEG][NUM_SYMBOL];
+
+    // open order attribution and net position (filled bid less filled ask
+    // quantity) per symbol, maintained from execution reports
+    pricingEngineOrderEntry_t order[PE_NUM_ORDER];
+    ap_int<32> position[NUM_SYMBOL];
+
+    // latest deferred response per symbol while pricing process is busy
+    orderBookResponse_t conflate[NUM_SYMBOL];
+    ap_uint<1> conflateValid[NUM_SYMBOL];
 
 };
 
@@ -22,8 +22,11 @@
 extern "C" void pricingEngineTop(pricingEngineRegControl_t &regControl,
                                  pricingEngineRegStatus_t &regStatus,
                                  ap_uint<1024> &regCapture,
-                                 pricingEngineRegStrategy_t regStrategies[NUM_SYMBOL],
+                                 pricingEngineRegStrategy_t regStrategies[PE_NUM_PARAM_BANK][NUM_SYMBOL],
+                                 pricingEngineRegLegs_t regLegs[PE_NUM_PARAM_BANK][NUM_SYMBOL],
                                  hls::stream<orderBookResponsePack_t> &responseStreamPack,
+                                 hls::stream<clockTickGeneratorEvent_t> &eventStreamPack,
+                                 hls::stream<orderEntryFillPack_t> &fillStreamPack,
                                  hls::stream<orderEntryOperationPack_t> &operationStreamPack);
 
 #endif
@@ -19,44 +19,87 @@
 extern "C" void pricingEngineTop(pricingEngineRegControl_t &regControl,
                                  pricingEngineRegStatus_t &regStatus,
                                  ap_uint<1024> &regCapture,
-                                 pricingEngineRegStrategy_t regStrategies[NUM_SYMBOL],
+                                 pricingEngineRegStrategy_t regStrategies[PE_NUM_PARAM_BANK][NUM_SYMBOL],
+                                 pricingEngineRegLegs_t regLegs[PE_NUM_PARAM_BANK][NUM_SYMBOL],
                                  hls::stream<orderBookResponsePack_t> &responseStreamPack,
+                                 hls::stream<clockTickGeneratorEvent_t> &eventStreamPack,
+                                 hls::stream<orderEntryFillPack_t> &fillStreamPack,
                                  hls::stream<orderEntryOperationPack_t> &operationStreamPack)
 {
 #pragma HLS INTERFACE s_axilite port=regControl bundle=control
 #pragma HLS INTERFACE s_axilite port=regStatus bundle=control
 #pragma HLS INTERFACE s_axilite port=regCapture bundle=control
 #pragma HLS INTERFACE s_axilite port=regStrategies bundle=control
+#pragma HLS INTERFACE s_axilite port=regLegs bundle=control
 #pragma HLS INTERFACE ap_none port=regControl
 #pragma HLS INTERFACE ap_none port=regStatus
 #pragma HLS INTERFACE ap_memory port=regCapture
 #pragma HLS INTERFACE ap_memory port=regStrategies
+#pragma HLS INTERFACE ap_memory port=regLegs
 #pragma HLS INTERFACE axis port=responseStreamPack
+#pragma HLS INTERFACE axis port=eventStreamPack
+#pragma HLS INTERFACE axis port=fillStreamPack
 #pragma HLS INTERFACE axis port=operationStreamPack
 #pragma HLS INTERFACE ap_ctrl_none port=return
 
     static hls::stream<orderBookResponse_t> responseStreamFIFO;
+    static hls::stream<ap_uint<8> > eventStreamFIFO;
+    static hls::stream<orderEntryFill_t> fillStreamFIFO;
     static hls::stream<orderEntryOperation_t> operationStreamFIFO;
     static PricingEngine kernel;
     static mmInterface intf;
 
+#pragma HLS STREAM variable=responseStreamFIFO depth=PE_RESPONSE_QUEUE_DEPTH
+
 #pragma HLS DISAGGREGATE variable=regControl
 #pragma HLS DISAGGREGATE variable=regStatus
+// parameter tables are double buffered, host only writes the inactive bank
+// (see paramCommit) so the bank read by the kernel is stable while running
 #pragma HLS STABLE variable=regStrategies
+#pragma HLS STABLE variable=regLegs
 #pragma HLS DATAFLOW disable_start_propagation
 
-    kernel.responsePull(regStatus.rxResponse,
+    kernel.responsePull(regControl.responseControl,
+                        regStatus.rxResponse,
+                        regStatus.conflateDefer,
+                        regStatus.conflateDrop,
                         responseStreamPack,
                         responseStreamFIFO);
 
+    kernel.eventPull(regStatus.rxEvent,
+                     eventStreamPack,
+                     eventStreamFIFO);
+
+    kernel.fillPull(regStatus.rxFill,
+                    fillStreamPack,
+                    fillStreamFIFO);
+
     kernel.pricingProcess(regControl.strategy,
+                          regControl.cacheControl,
+                          regControl.cacheWarmup,
+                          regControl.quoteTimeInForce,
+                          regControl.quoteHeartbeat,
+                          regControl.paramCommit,
+                          regControl.positionSelect,
                           regStatus.processResponse,
                           regStatus.strategyNone,
                           regStatus.strategyPeg,
                           regStatus.strategyLimit,
                           regStatus.strategyUnknown,
+                          regStatus.strategySpread,
+                          regStatus.cacheCold,
+                          regStatus.quoteCancel,
+                          regStatus.quoteRefresh,
+                          regStatus.paramBank,
+                          regStatus.paramCommit,
+                          regStatus.fillTrade,
+                          regStatus.fillUnknown,
+                          regStatus.position,
                           regStrategies,
+                          regLegs,
                           responseStreamFIFO,
+                          eventStreamFIFO,
+                          fillStreamFIFO,
                           operationStreamFIFO);
 
     kernel.operationPush(regControl.capture,
@@ -20,14 +20,173 @@
 
 #include "pricingengine_kernels.hpp"
 
-#define NUM_TEST_SAMPLE_PE (4)
+#define NUM_TEST_SAMPLE_PE    (8)
+#define NUM_TEST_WARMUP_PE    (2)
+#define NUM_TEST_INVALIDATE_PE (4) // sample index preceded by cache invalidate
+#define NUM_TEST_SPREAD_PE    (6)
+#define NUM_TEST_TICK_PE      (2)
+#define NUM_TEST_SUSTAIN_PE   (4) // ticks with a response on every kernel call
+#define NUM_TEST_FILL_PE      (3)
+#define NUM_TEST_CONFLATE_PE  (7)
+
+void responseGenerate(orderBookResponseVerify_t &responseVerify,
+                      orderBookResponse_t &response)
+{
+    response.symbolIndex = responseVerify.symbolIndex;
+
+    response.bidCount = (responseVerify.bidCount[4],
+                         responseVerify.bidCount[3],
+                         responseVerify.bidCount[2],
+                         responseVerify.bidCount[1],
+                         responseVerify.bidCount[0]);
+
+    response.bidPrice = (responseVerify.bidPrice[4],
+                         responseVerify.bidPrice[3],
+                         responseVerify.bidPrice[2],
+                         responseVerify.bidPrice[1],
+                         responseVerify.bidPrice[0]);
+
+    response.bidQuantity = (responseVerify.bidQuantity[4],
+                            responseVerify.bidQuantity[3],
+                            responseVerify.bidQuantity[2],
+                            responseVerify.bidQuantity[1],
+                            responseVerify.bidQuantity[0]);
+
+    response.askCount = (responseVerify.askCount[4],
+                         responseVerify.askCount[3],
+                         responseVerify.askCount[2],
+                         responseVerify.askCount[1],
+                         responseVerify.askCount[0]);
+
+    response.askPrice = (responseVerify.askPrice[4],
+                         responseVerify.askPrice[3],
+                         responseVerify.askPrice[2],
+                         responseVerify.askPrice[1],
+                         responseVerify.askPrice[0]);
+
+    response.askQuantity = (responseVerify.askQuantity[4],
+                            responseVerify.askQuantity[3],
+                            responseVerify.askQuantity[2],
+                            responseVerify.askQuantity[1],
+                            responseVerify.askQuantity[0]);
+
+    return;
+}
+
+// drain the operations issued since the last check and compare them in order
+// against the expected sequence, timestamps are not compared
+unsigned operationCheck(hls::stream<orderEntryOperationPack_t> &operationStreamPack,
+                        orderEntryOperation_t *expected,
+                        unsigned expectedCount)
+{
+    mmInterface intf;
+    orderEntryOperationPack_t operationPack;
+    orderEntryOperation_t operation;
+    unsigned mismatch=0, count=0;
+
+    while(!operationStreamPack.empty())
+    {
+        operationPack = operationStreamPack.read();
+        intf.orderEntryOperationUnpack(&operationPack, &operation);
+
+        std::cout << "ORDER_ENTRY_OPERATION: {"
+                  << operation.opCode << ","
+                  << operation.symbolIndex << ","
+                  << operation.orderId << ","
+                  << operation.quantity << ","
+                  << operation.price << ","
+                  << operation.direction << ","
+                  << operation.origOrderId << "}"
+                  << std::endl;
+
+        if((count >= expectedCount) ||
+           (operation.opCode != expected[count].opCode) ||
+           (operation.symbolIndex != expected[count].symbolIndex) ||
+           (operation.orderId != expected[count].orderId) ||
+           (operation.quantity != expected[count].quantity) ||
+           (operation.price != expected[count].price) ||
+           (operation.direction != expected[count].direction) ||
+           (operation.origOrderId != expected[count].origOrderId))
+        {
+            std::cout << "MISMATCH: unexpected operation " << count << std::endl;
+            ++mismatch;
+        }
+        ++count;
+    }
+
+    if(count < expectedCount)
+    {
+        std::cout << "MISMATCH: " << (expectedCount - count) << " operations missing" << std::endl;
+        mismatch += (expectedCount - count);
+    }
+
+    return mismatch;
+}
+
+// pull responses into a bounded queue while taking one queued response per
+// call as the pricing process would, books for the filler symbol used to hold
+// the queue full are skipped and every other book is compared in order
+unsigned conflateDrain(PricingEngine &kernel,
+                       ap_uint<32> &regResponseControl,
+                       ap_uint<32> &regConflateDefer,
+                       ap_uint<32> &regConflateDrop,
+                       hls::stream<orderBookResponsePack_t> &responseStreamPack,
+                       hls::stream<orderBookResponse_t> &responseQueue,
+                       ap_uint<8> fillerIndex,
+                       orderBookResponseVerify_t *expected,
+                       unsigned expectedCount)
+{
+    orderBookResponse_t response;
+    ap_uint<32> regRxResponse;
+    unsigned mismatch=0, count=0;
+
+    for(int i=0; i<(4*PE_RESPONSE_QUEUE_DEPTH); i++)
+    {
+        if(!responseQueue.empty())
+        {
+            response = responseQueue.read();
+            if(fillerIndex != response.symbolIndex)
+            {
+                std::cout << "CONFLATE_RESPONSE: {"
+                          << response.symbolIndex << ","
+                          << response.bidPrice.range(31,0) << "}"
+                          << std::endl;
+
+                if((count >= expectedCount) ||
+                   (response.symbolIndex != expected[count].symbolIndex) ||
+                   (response.bidPrice.range(31,0) != expected[count].bidPrice[0]))
+                {
+                    std::cout << "MISMATCH: unexpected response " << count << std::endl;
+                    ++mismatch;
+                }
+                ++count;
+            }
+        }
+
+        kernel.responsePull(regResponseControl,
+                            regRxResponse,
+                            regConflateDefer,
+                            regConflateDrop,
+                            responseStreamPack,
+                            responseQueue);
+    }
+
+    if(count < expectedCount)
+    {
+        std::cout << "MISMATCH: " << (expectedCount - count) << " responses missing" << std::endl;
+        mismatch += (expectedCount - count);
+    }
+
+    return mismatch;
+}
 
 int main()
 {
     pricingEngineRegControl_t regControl={0};
     pricingEngineRegStatus_t regStatus={0};
     ap_uint<1024> regCapture=0x0;
-    pricingEngineRegStrategy_t regStrategies[NUM_SYMBOL];
+    pricingEngineRegStrategy_t regStrategies[PE_NUM_PARAM_BANK][NUM_SYMBOL];
+    pricingEngineRegLegs_t regLegs[PE_NUM_PARAM_BANK][NUM_SYMBOL];
 
     mmInterface intf;
     orderBookResponseVerify_t responseVerify;
@@ -35,75 +194,67 @@ int main()
     orderBookResponsePack_t responsePack;
     orderEntryOperation_t operation;
     orderEntryOperationPack_t operationPack;
+    orderEntryFill_t fill;
+    orderEntryFillPack_t fillPack;
+
+    clockTickGeneratorEvent_t tickEvent;
+    unsigned cacheMismatch=0;
+    unsigned spreadMismatch=0;
+    unsigned tickMismatch=0;
+    unsigned conflateMismatch=0;
+    unsigned fillMismatch=0;
 
     hls::stream<orderBookResponsePack_t> responseStreamPackFIFO;
+    hls::stream<clockTickGeneratorEvent_t> eventStreamPackFIFO;
+    hls::stream<orderEntryFillPack_t> fillStreamPackFIFO;
     hls::stream<orderEntryOperationPack_t> operationStreamPackFIFO;
 
     std::cout << "PricingEngine Test" << std::endl;
     std::cout << "------------------" << std::endl;
 
     memset(&regStrategies, 0, sizeof(regStrategies));
+    memset(&regLegs, 0, sizeof(regLegs));
 
+    // top of book bid walks up on each sample after the first so every valid
+    // sample would trigger the PEG strategy, expected behaviour is:
+    //   0-1 = cold, warm-up of 2 updates
+    //   2   = order
+    //   3   = no order, top of book unchanged
+    //   4-5 = cold, host invalidate before sample 4 restarts warm-up
+    //   6-7 = order
     orderBookResponseVerify_t orderBookResponses[NUM_TEST_SAMPLE_PE] =
     {
         // symbolIndex, bidCount[], bidPrice[], bidQuantity[], askCount[], askPrice[], askQuantity[]
         {0,{1,1,1,0,0},{5853300,5853200,5853100,0,0},{18,18,18,0,0},{8,0,0,0,0},{5859100,0,0,0,0},{18,0,0,0,0}},
-        {0,{1,1,1,0,0},{5853300,5853200,5853100,0,0},{18,18,18,0,0},{1,1,0,0,0},{5859100,5859200,0,0,0},{18,18,0,0,0}},
-        {0,{1,1,1,0,0},{5853300,5853200,5853100,0,0},{18,18,18,0,0},{1,1,1,0,0},{5859100,5859200,5859300,0,0},{18,18,18,0,0}},
-        {0,{1,1,1,0,0},{5853300,5853200,5853100,0,0},{18,18,18,0,0},{1,1,1,1,0},{5859100,5859200,5859300,5859300,0},{18,18,100,18,0}},
+        {0,{1,1,1,0,0},{5853400,5853300,5853200,0,0},{18,18,18,0,0},{1,1,0,0,0},{5859100,5859200,0,0,0},{18,18,0,0,0}},
+        {0,{1,1,1,0,0},{5853500,5853400,5853300,0,0},{18,18,18,0,0},{1,1,1,0,0},{5859100,5859200,5859300,0,0},{18,18,18,0,0}},
+        {0,{1,1,1,0,0},{5853500,5853400,5853300,0,0},{18,18,18,0,0},{1,1,1,1,0},{5859100,5859200,5859300,5859300,0},{18,18,100,18,0}},
+        {0,{1,1,1,0,0},{5853600,5853500,5853400,0,0},{18,18,18,0,0},{1,1,1,1,0},{5859100,5859200,5859300,5859300,0},{18,18,100,18,0}},
+        {0,{1,1,1,0,0},{5853700,5853600,5853500,0,0},{18,18,18,0,0},{1,1,1,1,0},{5859100,5859200,5859300,5859300,0},{18,18,100,18,0}},
+        {0,{1,1,1,0,0},{5853800,5853700,5853600,0,0},{18,18,18,0,0},{1,1,1,1,0},{5859100,5859200,5859300,5859300,0},{18,18,100,18,0}},
+        {0,{1,1,1,0,0},{5853900,5853800,5853700,0,0},{18,18,18,0,0},{1,1,1,1,0},{5859100,5859200,5859300,5859300,0},{18,18,100,18,0}},
     };
 
-
-    for(int i=0; i<NUM_TEST_SAMPLE_PE; i++)
+    // order expected after each sample above, opCode 0xff where none is
+    orderEntryOperation_t orderEntryOperations[NUM_TEST_SAMPLE_PE] =
     {
-        responseVerify = orderBookResponses[i];
-
-        response.symbolIndex = responseVerify.symbolIndex;
-
-        response.bidCount = (responseVerify.bidCount[4],
-                             responseVerify.bidCount[3],
-                             responseVerify.bidCount[2],
-                             responseVerify.bidCount[1],
-                             responseVerify.bidCount[0]);
-
-        response.bidPrice = (responseVerify.bidPrice[4],
-                             responseVerify.bidPrice[3],
-                             responseVerify.bidPrice[2],
-                             responseVerify.bidPrice[1],
-                             responseVerify.bidPrice[0]);
-
-        response.bidQuantity = (responseVerify.bidQuantity[4],
-                                responseVerify.bidQuantity[3],
-                                responseVerify.bidQuantity[2],
-                                responseVerify.bidQuantity[1],
-                                responseVerify.bidQuantity[0]);
-
-        response.askCount = (responseVerify.askCount[4],
-                             responseVerify.askCount[3],
-                             responseVerify.askCount[2],
-                             responseVerify.askCount[1],
-                             responseVerify.askCount[0]);
-
-        response.askPrice = (responseVerify.askPrice[4],
-                             responseVerify.askPrice[3],
-                             responseVerify.askPrice[2],
-                             responseVerify.askPrice[1],
-                             responseVerify.askPrice[0]);
-
-        response.askQuantity = (responseVerify.askQuantity[4],
-                                responseVerify.askQuantity[3],
-                                responseVerify.askQuantity[2],
-                                responseVerify.askQuantity[1],
-                                responseVerify.askQuantity[0]);
-
-        intf.orderBookResponsePack(&response, &responsePack);
-        responseStreamPackFIFO.write(responsePack);
-    }
+        // timestamp, opCode, symbolIndex, orderId, quantity, price, direction
+        {0,0xff},
+        {0,0xff},
+        {0,ORDERENTRY_ADD,0,1,800,5853600,ORDER_BID},
+        {0,0xff},
+        {0,0xff},
+        {0,0xff},
+        {0,ORDERENTRY_ADD,0,2,800,5853900,ORDER_BID},
+        {0,ORDERENTRY_ADD,0,3,800,5854000,ORDER_BID},
+    };
 
     // configure
     regControl.control = 0x12345678;
     regControl.config = 0xdeadbeef;
     regControl.capture = 0x00000000;
+    regControl.cacheControl = 0x00000000;
+    regControl.cacheWarmup = NUM_TEST_WARMUP_PE;
 
     // strategy select (per symbol)
     //regStrategies[0].select = STRATEGY_PEG;
@@ -112,15 +263,431 @@ int main()
     // strategy select (global override)
     regControl.strategy = 0x80000001;
 
-    // kernel call to process operations
-    while(!responseStreamPackFIFO.empty())
+    for(int i=0; i<NUM_TEST_SAMPLE_PE; i++)
+    {
+        responseVerify = orderBookResponses[i];
+        responseGenerate(responseVerify, response);
+        intf.orderBookResponsePack(&response, &responsePack);
+        responseStreamPackFIFO.write(responsePack);
+
+        // pulse cache invalidate for symbol ahead of selected sample
+        if(NUM_TEST_INVALIDATE_PE == i)
+        {
+            regControl.cacheControl = (PE_CACHE_INVALIDATE | responseVerify.symbolIndex);
+        }
+
+        // kernel call to process operations
+        while(!responseStreamPackFIFO.empty())
+        {
+            pricingEngineTop(regControl,
+                             regStatus,
+                             regCapture,
+                             regStrategies,
+                             regLegs,
+                             responseStreamPackFIFO,
+                             eventStreamPackFIFO,
+                             fillStreamPackFIFO,
+                             operationStreamPackFIFO);
+        }
+
+        regControl.cacheControl = 0x00000000;
+
+        operation = orderEntryOperations[i];
+        cacheMismatch += operationCheck(operationStreamPackFIFO,
+                                        &operation,
+                                        ((0xff == operation.opCode) ? 0 : 1));
+    }
+
+    // samples 0-1 and 4-5 arrive while the symbol is warming up
+    if(4 != regStatus.cacheCold)
+    {
+        std::cout << "MISMATCH: cache cold count " << regStatus.cacheCold << std::endl;
+        ++cacheMismatch;
+    }
+
+    // pair of symbols 1 and 2 traded as a spread, each leg maps the other so
+    // an update to either side is evaluated against the cached mid of the
+    // partner, expected behaviour is:
+    //   0-3 = cold, warm-up of 2 updates per leg
+    //   4   = symbol 1 mid up 1000 vs symbol 2, sell symbol 1 at best ask
+    //   5   = symbol 2 mid down 2000 vs symbol 1, buy symbol 2 at best bid
+    orderBookResponseVerify_t orderBookSpreadResponses[NUM_TEST_SPREAD_PE] =
+    {
+        // symbolIndex, bidCount[], bidPrice[], bidQuantity[], askCount[], askPrice[], askQuantity[]
+        {1,{1,0,0,0,0},{1000000,0,0,0,0},{10,0,0,0,0},{1,0,0,0,0},{1000200,0,0,0,0},{10,0,0,0,0}},
+        {2,{1,0,0,0,0},{1000000,0,0,0,0},{10,0,0,0,0},{1,0,0,0,0},{1000200,0,0,0,0},{10,0,0,0,0}},
+        {1,{1,0,0,0,0},{1000000,0,0,0,0},{10,0,0,0,0},{1,0,0,0,0},{1000200,0,0,0,0},{10,0,0,0,0}},
+        {2,{1,0,0,0,0},{1000000,0,0,0,0},{10,0,0,0,0},{1,0,0,0,0},{1000200,0,0,0,0},{10,0,0,0,0}},
+        {1,{1,0,0,0,0},{1001000,0,0,0,0},{10,0,0,0,0},{1,0,0,0,0},{1001200,0,0,0,0},{10,0,0,0,0}},
+        {2,{1,0,0,0,0},{999000,0,0,0,0},{10,0,0,0,0},{1,0,0,0,0},{999200,0,0,0,0},{10,0,0,0,0}},
+    };
+
+    orderEntryOperation_t orderEntrySpreadOperations[2] =
+    {
+        // timestamp, opCode, symbolIndex, orderId, quantity, price, direction
+        {0,ORDERENTRY_ADD,1,4,100,1001200,ORDER_ASK},
+        {0,ORDERENTRY_ADD,2,5,100,999000,ORDER_BID},
+    };
+
+    // strategy select (per symbol), programmed into inactive parameter bank
+    // and swapped in with a single commit while the kernel is running
+    regControl.strategy = 0x00000000;
+    regStrategies[1][1].select = STRATEGY_SPREAD;
+    regStrategies[1][2].select = STRATEGY_SPREAD;
+
+    // leg map, self weight +1, partner weight -1
+    regLegs[1][1].legs = 0x00000002;
+    regLegs[1][1].weights = 0x010000ff;
+    regLegs[1][1].threshold = 500;
+    regLegs[1][1].quantity = 100;
+    regLegs[1][2].legs = 0x00000001;
+    regLegs[1][2].weights = 0x010000ff;
+    regLegs[1][2].threshold = 500;
+    regLegs[1][2].quantity = 100;
+
+    regControl.paramCommit = 1;
+
+    // commit is acknowledged without market data, host polls paramBank
+    pricingEngineTop(regControl,
+                     regStatus,
+                     regCapture,
+                     regStrategies,
+                     regLegs,
+                     responseStreamPackFIFO,
+                     eventStreamPackFIFO,
+                     fillStreamPackFIFO,
+                     operationStreamPackFIFO);
+
+    if(1 != regStatus.paramBank)
+    {
+        std::cout << "MISMATCH: paramBank=" << regStatus.paramBank << " expected 1 after commit" << std::endl;
+        ++spreadMismatch;
+    }
+
+    for(int i=0; i<NUM_TEST_SPREAD_PE; i++)
+    {
+        responseVerify = orderBookSpreadResponses[i];
+        responseGenerate(responseVerify, response);
+        intf.orderBookResponsePack(&response, &responsePack);
+        responseStreamPackFIFO.write(responsePack);
+
+        // kernel call to process operations
+        while(!responseStreamPackFIFO.empty())
+        {
+            pricingEngineTop(regControl,
+                             regStatus,
+                             regCapture,
+                             regStrategies,
+                             regLegs,
+                             responseStreamPackFIFO,
+                             eventStreamPackFIFO,
+                             fillStreamPackFIFO,
+                             operationStreamPackFIFO);
+        }
+    }
+
+    spreadMismatch += operationCheck(operationStreamPackFIFO,
+                                     orderEntrySpreadOperations,
+                                     2);
+
+    // execution reports for the orders above, each arriving with a burst of
+    // symbol 4 books (no strategy selected) queued ahead of the pricing
+    // process, the report is applied without waiting for the books to be
+    // priced, expected behaviour is:
+    //   0 = partial fill of 1 on the symbol 0 quote (orderId 3), stays open
+    //   1 = full fill of the symbol 1 spread sell (orderId 4), quote closed
+    //       and symbol 1 position short 100
+    //   2 = unknown orderId, counted only
+    orderEntryFill_t orderEntryFills[NUM_TEST_FILL_PE] =
+    {
+        // orderId, execType, quantity, price
+        {3,EXEC_PARTIAL_FILL,1,5853900},
+        {4,EXEC_FILL,100,1001200},
+        {99,EXEC_FILL,100,1001200},
+    };
+    unsigned fillTrade[NUM_TEST_FILL_PE] = {1,2,2};
+    unsigned fillUnknown[NUM_TEST_FILL_PE] = {0,0,1};
+    ap_uint<32> fillTradeBase=regStatus.fillTrade;
+    ap_uint<32> fillUnknownBase=regStatus.fillUnknown;
+
+    orderBookResponseVerify_t orderBookFillResponse =
+        {4,{1,0,0,0,0},{3000000,0,0,0,0},{10,0,0,0,0},{1,0,0,0,0},{3000200,0,0,0,0},{10,0,0,0,0}};
+
+    regControl.positionSelect = 1;
+
+    for(int i=0; i<NUM_TEST_FILL_PE; i++)
+    {
+        responseGenerate(orderBookFillResponse, response);
+        intf.orderBookResponsePack(&response, &responsePack);
+        for(int j=0; j<8; j++)
+        {
+            responseStreamPackFIFO.write(responsePack);
+        }
+
+        fill = orderEntryFills[i];
+        intf.orderEntryFillPack(&fill, &fillPack);
+        fillStreamPackFIFO.write(fillPack);
+
+        // kernel calls to pull and apply the fill
+        for(int j=0; j<2; j++)
+        {
+            pricingEngineTop(regControl,
+                             regStatus,
+                             regCapture,
+                             regStrategies,
+                             regLegs,
+                             responseStreamPackFIFO,
+                             eventStreamPackFIFO,
+                             fillStreamPackFIFO,
+                             operationStreamPackFIFO);
+        }
+
+        if((fillTrade[i] != (regStatus.fillTrade - fillTradeBase)) ||
+           (fillUnknown[i] != (regStatus.fillUnknown - fillUnknownBase)))
+        {
+            std::cout << "MISMATCH: fill " << i << " not applied ahead of pending responses" << std::endl;
+            ++fillMismatch;
+        }
+
+        // kernel calls to price the queued books
+        while(!responseStreamPackFIFO.empty() || (regStatus.processResponse != regStatus.rxResponse))
+        {
+            pricingEngineTop(regControl,
+                             regStatus,
+                             regCapture,
+                             regStrategies,
+                             regLegs,
+                             responseStreamPackFIFO,
+                             eventStreamPackFIFO,
+                             fillStreamPackFIFO,
+                             operationStreamPackFIFO);
+        }
+    }
+
+    if(0xffffff9c != regStatus.position)
+    {
+        std::cout << "MISMATCH: symbol 1 position " << regStatus.position << " expected -100" << std::endl;
+        ++fillMismatch;
+    }
+
+    // quote timers, every symbol above other than the filled symbol 1 has a
+    // resting quote, heartbeat of 1 tick and time-in-force of 2 ticks, the
+    // host invalidates symbol 2 with the first tick, expected behaviour is:
+    //   tick 1 = re-quote (modify) symbol 0 at cached top of book for the
+    //            remaining unfilled quantity, symbol 2 held as not valid
+    //   tick 2 = cancel (delete) symbols 0 and 2
+    // every modify and cancel carries a fresh orderId, origOrderId is the
+    // order it replaces or cancels
+    orderEntryOperation_t orderEntryTickOperations[3] =
+    {
+        // timestamp, opCode, symbolIndex, orderId, quantity, price, direction, origOrderId
+        {0,ORDERENTRY_MODIFY,0,6,799,5853900,ORDER_BID,3},
+        {0,ORDERENTRY_DELETE,0,7,799,5853900,ORDER_BID,6},
+        {0,ORDERENTRY_DELETE,2,8,100,999000,ORDER_BID,5},
+    };
+
+    regControl.quoteHeartbeat = 1;
+    regControl.quoteTimeInForce = 2;
+
+    for(int i=0; i<NUM_TEST_TICK_PE; i++)
+    {
+        tickEvent.data = i;
+        tickEvent.keep = 0x1;
+        tickEvent.last = 1;
+        eventStreamPackFIFO.write(tickEvent);
+
+        if(0 == i)
+        {
+            regControl.cacheControl = (PE_CACHE_INVALIDATE | 2);
+        }
+
+        // kernel calls to consume tick and sweep all symbols
+        for(int j=0; j<(NUM_SYMBOL+1); j++)
+        {
+            pricingEngineTop(regControl,
+                             regStatus,
+                             regCapture,
+                             regStrategies,
+                             regLegs,
+                             responseStreamPackFIFO,
+                             eventStreamPackFIFO,
+                             fillStreamPackFIFO,
+                             operationStreamPackFIFO);
+
+            regControl.cacheControl = 0x00000000;
+        }
+    }
+
+    tickMismatch += operationCheck(operationStreamPackFIFO,
+                                   orderEntryTickOperations,
+                                   3);
+
+    // sustained market data, a symbol 3 response on every kernel call while
+    // a symbol 0 quote rests with a time-in-force of 2 ticks, expected
+    // behaviour is:
+    //   order (add) symbol 0 at best bid +100
+    //   cancel (delete) symbol 0 after 2 ticks, the timer sweep shares the
+    //   cycles with the pending responses rather than waiting for idle
+    orderBookResponseVerify_t orderBookSustainResponses[2] =
+    {
+        // symbolIndex, bidCount[], bidPrice[], bidQuantity[], askCount[], askPrice[], askQuantity[]
+        {0,{1,0,0,0,0},{5854100,0,0,0,0},{18,0,0,0,0},{1,0,0,0,0},{5859100,0,0,0,0},{18,0,0,0,0}},
+        {3,{1,0,0,0,0},{2000000,0,0,0,0},{10,0,0,0,0},{1,0,0,0,0},{2000200,0,0,0,0},{10,0,0,0,0}},
+    };
+
+    orderEntryOperation_t orderEntrySustainOperations[2] =
+    {
+        // timestamp, opCode, symbolIndex, orderId, quantity, price, direction, origOrderId
+        {0,ORDERENTRY_ADD,0,9,800,5854200,ORDER_BID,0},
+        {0,ORDERENTRY_DELETE,0,10,800,5854200,ORDER_BID,9},
+    };
+
+    regControl.strategy = 0x80000001;
+    regControl.quoteHeartbeat = 0;
+
+    responseVerify = orderBookSustainResponses[0];
+    responseGenerate(responseVerify, response);
+    intf.orderBookResponsePack(&response, &responsePack);
+    responseStreamPackFIFO.write(responsePack);
+
+    responseVerify = orderBookSustainResponses[1];
+    responseGenerate(responseVerify, response);
+    intf.orderBookResponsePack(&response, &responsePack);
+
+    for(int i=0; i<(2*NUM_TEST_SUSTAIN_PE); i++)
+    {
+        // ticks on the first half, then let the response backlog drain
+        if(i < NUM_TEST_SUSTAIN_PE)
+        {
+            tickEvent.data = i;
+            eventStreamPackFIFO.write(tickEvent);
+        }
+
+        for(int j=0; j<((2*NUM_SYMBOL)+8); j++)
+        {
+            if(i < NUM_TEST_SUSTAIN_PE)
+            {
+                responseStreamPackFIFO.write(responsePack);
+            }
+
+            pricingEngineTop(regControl,
+                             regStatus,
+                             regCapture,
+                             regStrategies,
+                             regLegs,
+                             responseStreamPackFIFO,
+                             eventStreamPackFIFO,
+                             fillStreamPackFIFO,
+                             operationStreamPackFIFO);
+        }
+    }
+
+    tickMismatch += operationCheck(operationStreamPackFIFO,
+                                   orderEntrySustainOperations,
+                                   2);
+
+    // conflation, the queue ahead of the pricing process never fills with
+    // the streams above so responsePull is driven directly on a queue of the
+    // kernel depth, the conflation counters are shared with the kernel above
+    // so increments are checked, expected behaviour is:
+    //   queue held full by symbol 4, three symbol 5 books arrive, the first
+    //   is deferred and the next two conflated into it, only the newest
+    //   symbol 5 book is delivered once the queue has space
+    //   queue held full again with a symbol 6 book deferred, conflation then
+    //   disabled, the deferred book is flushed and the two books following
+    //   it are delivered in order rather than conflated
+    orderBookResponseVerify_t orderBookConflateResponses[NUM_TEST_CONFLATE_PE] =
+    {
+        // symbolIndex, bidCount[], bidPrice[], bidQuantity[], askCount[], askPrice[], askQuantity[]
+        {4,{1,0,0,0,0},{3000000,0,0,0,0},{10,0,0,0,0},{1,0,0,0,0},{3000200,0,0,0,0},{10,0,0,0,0}},
+        {5,{1,0,0,0,0},{4000000,0,0,0,0},{10,0,0,0,0},{1,0,0,0,0},{4000400,0,0,0,0},{10,0,0,0,0}},
+        {5,{1,0,0,0,0},{4000100,0,0,0,0},{10,0,0,0,0},{1,0,0,0,0},{4000400,0,0,0,0},{10,0,0,0,0}},
+        {5,{1,0,0,0,0},{4000200,0,0,0,0},{10,0,0,0,0},{1,0,0,0,0},{4000400,0,0,0,0},{10,0,0,0,0}},
+        {6,{1,0,0,0,0},{6000000,0,0,0,0},{10,0,0,0,0},{1,0,0,0,0},{6000400,0,0,0,0},{10,0,0,0,0}},
+        {6,{1,0,0,0,0},{6000100,0,0,0,0},{10,0,0,0,0},{1,0,0,0,0},{6000400,0,0,0,0},{10,0,0,0,0}},
+        {6,{1,0,0,0,0},{6000200,0,0,0,0},{10,0,0,0,0},{1,0,0,0,0},{6000400,0,0,0,0},{10,0,0,0,0}},
+    };
+
+    PricingEngine conflateKernel;
+    hls::stream<orderBookResponse_t, PE_RESPONSE_QUEUE_DEPTH> responseQueue;
+    ap_uint<32> regResponseControl=0;
+    ap_uint<32> regRxResponse=0;
+    ap_uint<32> regConflateDefer=0;
+    ap_uint<32> regConflateDrop=0;
+    ap_uint<32> conflateDefer=regStatus.conflateDefer;
+    ap_uint<32> conflateDrop=regStatus.conflateDrop;
+
+    for(int i=0; i<(PE_RESPONSE_QUEUE_DEPTH+3); i++)
+    {
+        responseVerify = orderBookConflateResponses[(i < PE_RESPONSE_QUEUE_DEPTH) ? 0 : (i-PE_RESPONSE_QUEUE_DEPTH+1)];
+        responseGenerate(responseVerify, response);
+        intf.orderBookResponsePack(&response, &responsePack);
+        responseStreamPackFIFO.write(responsePack);
+
+        conflateKernel.responsePull(regResponseControl,
+                                    regRxResponse,
+                                    regConflateDefer,
+                                    regConflateDrop,
+                                    responseStreamPackFIFO,
+                                    responseQueue);
+    }
+
+    if(!responseQueue.full() || (1 != (regConflateDefer - conflateDefer)) || (2 != (regConflateDrop - conflateDrop)))
+    {
+        std::cout << "MISMATCH: queue full=" << responseQueue.full()
+                  << " defer=" << (regConflateDefer - conflateDefer)
+                  << " drop=" << (regConflateDrop - conflateDrop)
+                  << " expected full, 1 deferral and 2 conflated" << std::endl;
+        ++conflateMismatch;
+    }
+
+    conflateMismatch += conflateDrain(conflateKernel,
+                                      regResponseControl,
+                                      regConflateDefer,
+                                      regConflateDrop,
+                                      responseStreamPackFIFO,
+                                      responseQueue,
+                                      4,
+                                      &orderBookConflateResponses[3],
+                                      1);
+
+    for(int i=0; i<(PE_RESPONSE_QUEUE_DEPTH+3); i++)
+    {
+        responseVerify = orderBookConflateResponses[(i < PE_RESPONSE_QUEUE_DEPTH) ? 0 : (i-PE_RESPONSE_QUEUE_DEPTH+4)];
+        responseGenerate(responseVerify, response);
+        intf.orderBookResponsePack(&response, &responsePack);
+        responseStreamPackFIFO.write(responsePack);
+
+        // disabled once the first symbol 6 book is deferred
+        if(i > PE_RESPONSE_QUEUE_DEPTH)
+        {
+            regResponseControl = PE_CONFLATE_DISABLE;
+        }
+
+        conflateKernel.responsePull(regResponseControl,
+                                    regRxResponse,
+                                    regConflateDefer,
+                                    regConflateDrop,
+                                    responseStreamPackFIFO,
+                                    responseQueue);
+    }
+
+    conflateMismatch += conflateDrain(conflateKernel,
+                                      regResponseControl,
+                                      regConflateDefer,
+                                      regConflateDrop,
+                                      responseStreamPackFIFO,
+                                      responseQueue,
+                                      4,
+                                      &orderBookConflateResponses[4],
+                                      3);
+
+    if((2 != (regConflateDefer - conflateDefer)) || (2 != (regConflateDrop - conflateDrop)))
     {
-        pricingEngineTop(regControl,
-                         regStatus,
-                         regCapture,
-                         regStrategies,
-                         responseStreamPackFIFO,
-                         operationStreamPackFIFO);
+        std::cout << "MISMATCH: defer=" << (regConflateDefer - conflateDefer)
+                  << " drop=" << (regConflateDrop - conflateDrop)
+                  << " expected 2 deferrals and 2 conflated" << std::endl;
+        ++conflateMismatch;
     }
 
     // drain response stream
@@ -152,7 +719,24 @@ int main()
     std::cout << "PE_STRATEGY_NA=" << regStatus.strategyUnknown << " ";
     std::cout << "PE_RX_EVENT=" << regStatus.rxEvent << " ";
     std::cout << "PE_DEBUG=" << regStatus.debug << " ";
+    std::cout << "PE_CACHE_COLD=" << regStatus.cacheCold << " ";
+    std::cout << "PE_STRATEGY_SPREAD=" << regStatus.strategySpread << " ";
+    std::cout << "PE_QUOTE_CANCEL=" << regStatus.quoteCancel << " ";
+    std::cout << "PE_QUOTE_REFRESH=" << regStatus.quoteRefresh << " ";
+    std::cout << "PE_PARAM_BANK=" << regStatus.paramBank << " ";
+    std::cout << "PE_PARAM_COMMIT=" << regStatus.paramCommit << " ";
+    std::cout << "PE_CONFLATE_DEFER=" << regStatus.conflateDefer << " ";
+    std::cout << "PE_CONFLATE_DROP=" << regStatus.conflateDrop << " ";
+    std::cout << "PE_RX_FILL=" << regStatus.rxFill << " ";
+    std::cout << "PE_FILL_TRADE=" << regStatus.fillTrade << " ";
+    std::cout << "PE_FILL_UNKNOWN=" << regStatus.fillUnknown << " ";
+    std::cout << "PE_POSITION=" << regStatus.position << " ";
     std::cout << std::endl;
+    std::cout << std::dec << "CACHE: checked " << NUM_TEST_SAMPLE_PE << " responses, " << cacheMismatch << " mismatches" << std::endl;
+    std::cout << "SPREAD: checked " << NUM_TEST_SPREAD_PE << " responses, " << spreadMismatch << " mismatches" << std::endl;
+    std::cout << "TICK: checked " << (NUM_TEST_TICK_PE + NUM_TEST_SUSTAIN_PE) << " ticks, " << tickMismatch << " mismatches" << std::endl;
+    std::cout << "FILL: checked " << NUM_TEST_FILL_PE << " reports, " << fillMismatch << " mismatches" << std::endl;
+    std::cout << "CONFLATE: checked " << NUM_TEST_CONFLATE_PE << " responses, " << conflateMismatch << " mismatches" << std::endl;
 
     std::cout << std::endl;
     std::cout << "Done!" << std::endl;